@@ -0,0 +1,93 @@
+# Embed GLSL files into a target as constexpr arrays, to be loaded by
+# gl_util::Shader::loadFromSource() without reading the files at runtime.
+#
+#   gl_util_embed_shaders(<target> <namespace> FILES <file>...)
+#
+# Generates '<namespace>.h' in the build tree, and adds its directory to the include
+# directories of the target. For each file, e.g. 'shaders/scene.vs', the header
+# defines
+#
+#   namespace <namespace> {
+#   inline constexpr char scene_vs_data[] = { ... };
+#   inline constexpr std::string_view scene_vs(scene_vs_data, <size>);
+#   inline void addSources();  // add all files to gl_util::ShaderPreprocessor
+#   }
+#
+# 'addSources()' makes the files includable by their names, e.g. '#include "light.glsl"'.
+# The header is generated again at build time once any of the files is changed.
+#
+# This file is also the generator, run in script mode by the build.
+
+if(CMAKE_SCRIPT_MODE_FILE)
+    # Script mode: -DNAMESPACE=... -DOUTPUT=... -DFILES=a|b
+    string(REPLACE "|" ";" FILES "${FILES}")
+    set(content "// Generated by gl_util_embed_shaders(), do not edit.\n")
+    string(APPEND content "#pragma once\n#include <string_view>\n")
+    string(APPEND content "#include <gl_util/gl_shader_preprocessor.h>\n\n")
+    string(APPEND content "namespace ${NAMESPACE} {\n\n")
+    set(add_sources "")
+    # The regex has no repetition count.
+    set(byte_16 "")
+    foreach(i RANGE 1 16)
+        string(APPEND byte_16 "'[^']+',")
+    endforeach()
+    foreach(file ${FILES})
+        get_filename_component(name ${file} NAME)
+        string(MAKE_C_IDENTIFIER ${name} identifier)
+        file(READ ${file} hex HEX)
+        string(LENGTH "${hex}" length)
+        math(EXPR size "${length} / 2")
+        # 16 bytes per line, each byte as a char literal so non-ASCII bytes are kept.
+        string(REGEX REPLACE "([0-9a-f][0-9a-f])" "'\\\\x\\1'," bytes "${hex}")
+        string(REGEX REPLACE "(${byte_16})" "\\1\n    " bytes "${bytes}")
+        string(APPEND content "/** ${name} **/\n")
+        string(APPEND content "inline constexpr char ${identifier}_data[] = {\n")
+        string(APPEND content "    ${bytes}'\\0'\n};\n")
+        string(APPEND content "inline constexpr std::string_view ${identifier}"
+                              "(${identifier}_data, ${size});\n\n")
+        string(APPEND add_sources
+               "    gl_util::ShaderPreprocessor::addSource(\"${name}\", ${identifier});\n")
+    endforeach()
+    string(APPEND content "/** Make the files includable by their names **/\n")
+    string(APPEND content "inline void addSources() {\n${add_sources}}\n\n")
+    string(APPEND content "} // namespace ${NAMESPACE}\n")
+
+    # Written only if changed, so the dependents are not rebuilt for nothing.
+    if(EXISTS ${OUTPUT})
+        file(READ ${OUTPUT} old_content)
+    endif()
+    if(NOT "${old_content}" STREQUAL "${content}")
+        file(WRITE ${OUTPUT} "${content}")
+    endif()
+    return()
+endif()
+
+set(GL_UTIL_EMBED_SCRIPT ${CMAKE_CURRENT_LIST_FILE} CACHE INTERNAL "GLSL embed script")
+
+function(gl_util_embed_shaders target namespace)
+    cmake_parse_arguments(EMBED "" "" "FILES" ${ARGN})
+    if(NOT EMBED_FILES)
+        message(FATAL_ERROR "gl_util_embed_shaders(${target}): no FILES given.")
+    endif()
+
+    set(files "")
+    foreach(file ${EMBED_FILES})
+        get_filename_component(file ${file} ABSOLUTE)
+        list(APPEND files ${file})
+    endforeach()
+
+    set(output_dir ${CMAKE_CURRENT_BINARY_DIR}/gl_util_embed/${target})
+    set(output ${output_dir}/${namespace}.h)
+    # Joined by '|', since ';' splits the argument of the command.
+    string(REPLACE ";" "|" files_argument "${files}")
+    add_custom_command(
+        OUTPUT ${output}
+        COMMAND ${CMAKE_COMMAND} -DNAMESPACE=${namespace} -DOUTPUT=${output}
+                "-DFILES=${files_argument}" -P ${GL_UTIL_EMBED_SCRIPT}
+        DEPENDS ${files} ${GL_UTIL_EMBED_SCRIPT}
+        COMMENT "Embedding GLSL files into ${namespace}.h"
+        VERBATIM
+    )
+    target_sources(${target} PRIVATE ${output})
+    target_include_directories(${target} PUBLIC $<BUILD_INTERFACE:${output_dir}>)
+endfunction()
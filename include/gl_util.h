@@ -26,11 +26,28 @@
 #include <iostream>
 
 #include "gl_util/gl_window.h"
+#include "gl_util/gl_state_cache.h"
 #include "gl_util/gl_shader.h"
+#include "gl_util/gl_shader_preprocessor.h"
+#include "gl_util/gl_shader_variants.h"
+#include "gl_util/gl_shader_registry.h"
+#include "gl_util/gl_shader_batch.h"
+#include "gl_util/gl_program_pipeline.h"
+#include "gl_util/gl_compute_shader.h"
+#include "gl_util/gl_uniform_buffer.h"
+#include "gl_util/gl_storage_buffer.h"
+#include "gl_util/gl_program_cache.h"
+#include "gl_util/gl_file_watcher.h"
 #include "gl_util/gl_vavbebo.h"
 #include "gl_util/gl_texture.h"
+#include "gl_util/gl_framebuffer.h"
+#include "gl_util/gl_readback.h"
+#include "gl_util/gl_profiler.h"
+#include "gl_util/gl_render_thread.h"
+#include "gl_util/gl_event_loop.h"
 #include "gl_util/gl_camera.h"
 #include "gl_util/gl_projection.h"
+#include "gl_util/gl_stereo.h"
 
 /* The other uitilities */
 GL_UTIL_BEGIN
@@ -0,0 +1,158 @@
+/** -------------------------------------------------------------------------------------
+ *
+ *   				                 OpenGL Utilities
+ *
+ * @file 		gl_compute_shader.h
+ *
+ * @brief 		A manager for compute program object.
+ *
+ * @author		Longfei Wang
+ *
+ * @version		1.0.0
+ *
+ * @date		2026/10/16
+ *
+ * @license		MIT
+ *
+ * Copyright (C) 2021-Now Longfei Wang.
+ * ------------------------------------------------------------------------------------*/
+#ifndef GL_UTIL_COMPUTE_SHADER_H_LF
+#define GL_UTIL_COMPUTE_SHADER_H_LF
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <string>
+#include "gl_util_ns.h"
+#include "gl_shader.h"
+
+GL_UTIL_BEGIN
+
+/**
+ * @brief A manager for compute program object (GL 4.3+).
+ *
+ * @details The program is loaded the same way as gl_util::Shader, so the
+ * preprocessor, the binary cache, watch(), the uniform handles and the reflection
+ * all work for compute programs as well.
+ * @code
+ * // layout(local_size_x = 16, local_size_y = 16) in;
+ * // layout(r32f, binding = 0) uniform image2D depth;
+ * gl_util::ComputeShader linearize;
+ * linearize.load("linearize.cs");
+ * gl_util::ComputeShader::bindImage(0, depth_texture, GL_READ_WRITE, GL_R32F);
+ * linearize.dispatchThreads(width, height);
+ * gl_util::ComputeShader::memoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+ * @endcode
+ */
+class ComputeShader : public Shader {
+public:
+    /**
+     * @brief Construct a new ComputeShader object.
+     */
+    ComputeShader();
+
+    /**
+     * @brief Load the compute shader file.
+     *
+     * @param cs_path  The path of compute shader file
+     * @param defines  The macros injected after '#version'.
+     * @return
+     *   @retval true  Succeed to load the file.
+     *   @retval false Otherwise.
+     */
+    bool load(const std::string &cs_path, const ShaderDefines &defines = ShaderDefines());
+
+    /**
+     * @brief Submit the compute shader file without waiting for the driver, see
+     * gl_util::Shader::loadAsync().
+     */
+    bool loadAsync(const std::string &cs_path,
+                   const ShaderDefines &defines = ShaderDefines());
+
+    /**
+     * @brief Load the compute shader code in memory, see
+     * gl_util::Shader::loadFromSource().
+     */
+    bool loadFromSource(std::string_view cs_code,
+                        const ShaderDefines &defines = ShaderDefines());
+
+    /**
+     * @brief Load the compute SPIR-V module, or the GLSL file if SPIR-V is not
+     * supported, see gl_util::Shader::loadSpirv(). The work group size can be
+     * specialized by 'layout(local_size_x_id = N) in;'.
+     *
+     * @param cs_spirv_path  The path of compute SPIR-V file.
+     * @param constants  The specialization constants.
+     * @param cs_glsl_path  The path of compute shader file of the fallback, empty for
+     * no fallback.
+     */
+    bool loadSpirv(const std::string &cs_spirv_path,
+                   const SpecializationConstants &constants = SpecializationConstants(),
+                   const std::string &cs_glsl_path = std::string());
+
+    /**
+     * @brief Get the local work group size declared by the shader, zero if the
+     * program is not created.
+     */
+    glm::uvec3 workGroupSize() const;
+
+    /**
+     * @brief Activate the program and dispatch the work groups.
+     *
+     * @param x  The number of work groups in X.
+     * @param y  The number of work groups in Y.
+     * @param z  The number of work groups in Z.
+     */
+    void dispatch(GLuint x, GLuint y = 1, GLuint z = 1);
+
+    /**
+     * @brief Activate the program and dispatch enough work groups to cover the
+     * number of invocations, e.g. the pixels of an image.
+     *
+     * @note The shader should return early for the invocations out of range.
+     */
+    void dispatchThreads(GLuint width, GLuint height = 1, GLuint depth = 1);
+
+    /**
+     * @brief Activate the program and dispatch the work groups read from the buffer,
+     * i.e. { GLuint x, y, z } written by GPU, such as a culling pass.
+     *
+     * @param buffer  The buffer object holding the work group counts.
+     * @param offset  The offset of the counts in bytes, a multiple of 4.
+     */
+    void dispatchIndirect(GLuint buffer, GLintptr offset = 0);
+
+    /**
+     * @brief glMemoryBarrier(), order the writes of the dispatches before the
+     * following reads of the kinds in barriers.
+     *
+     * @param barriers  The bits like GL_SHADER_STORAGE_BARRIER_BIT,
+     * GL_SHADER_IMAGE_ACCESS_BARRIER_BIT, GL_TEXTURE_FETCH_BARRIER_BIT,
+     * GL_COMMAND_BARRIER_BIT (for dispatchIndirect or indirect draws), or
+     * GL_BUFFER_UPDATE_BARRIER_BIT (for reading the buffer back).
+     */
+    static void memoryBarrier(GLbitfield barriers = GL_ALL_BARRIER_BITS);
+
+    /**
+     * @brief glMemoryBarrierByRegion(), a cheaper barrier for the fragment shaders
+     * reading the writes of the same pixels.
+     */
+    static void memoryBarrierByRegion(GLbitfield barriers = GL_ALL_BARRIER_BITS);
+
+    /**
+     * @brief glBindImageTexture(), bind a level of a texture to an image unit.
+     *
+     * @param unit  The image unit, i.e. 'binding' of the image in GLSL.
+     * @param texture  The texture object.
+     * @param access  GL_READ_ONLY, GL_WRITE_ONLY or GL_READ_WRITE.
+     * @param format  The format of the image in GLSL, like GL_RGBA8 or GL_R32F.
+     * @param level  The mipmap level.
+     */
+    static void bindImage(GLuint unit, GLuint texture, GLenum access, GLenum format,
+                          GLint level = 0);
+
+private:
+    mutable glm::uvec3 _group_size;         ///< The cached local work group size
+    mutable uint32_t   _group_generation;   ///< The generation of the cached size
+};
+
+GL_UTIL_END
+#endif // GL_UTIL_COMPUTE_SHADER_H_LF
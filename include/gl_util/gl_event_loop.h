@@ -0,0 +1,153 @@
+/** -------------------------------------------------------------------------------------
+ *
+ *   				                 OpenGL Utilities
+ *
+ * @file 		gl_event_loop.h
+ *
+ * @brief 		A central event pump for all the windows.
+ *
+ * @author		Longfei Wang
+ *
+ * @version		1.0.0
+ *
+ * @date		2026/10/16
+ *
+ * @license		MIT
+ *
+ * Copyright (C) 2021-Now Longfei Wang.
+ * ------------------------------------------------------------------------------------*/
+#ifndef GL_UTIL_EVENT_LOOP_H_LF
+#define GL_UTIL_EVENT_LOOP_H_LF
+#include <cstdint>
+#include <vector>
+#include "gl_util_ns.h"
+
+GL_UTIL_BEGIN
+
+class Window;
+
+/**
+ * @brief A timestamped input or window event.
+ */
+struct Event {
+    enum Type {
+        KEY,            ///< key, scancode, action, mods
+        CHAR,           ///< codepoint
+        MOUSE_BUTTON,   ///< key (the button), action, mods
+        CURSOR_POS,     ///< x, y
+        SCROLL,         ///< x, y (the offsets)
+        RESIZE,         ///< x, y (the new window size)
+        FOCUS,          ///< action (1 if focused, 0 otherwise)
+        CLOSE           ///< no parameter
+    };
+
+    Type   type;            ///< The type of the event
+    double time;            ///< The time in seconds from glfwGetTime()
+    int    key;             ///< The key or the mouse button
+    int    scancode;        ///< The system-specific scancode of the key
+    int    action;          ///< GLFW_PRESS, GLFW_RELEASE or GLFW_REPEAT
+    int    mods;            ///< The modifier key flags
+    double x;               ///< The x value, see Type
+    double y;               ///< The y value, see Type
+    unsigned int codepoint; ///< The Unicode code point of the character
+};
+
+/**
+ * @brief A central event pump that owns polling and waiting for all the windows.
+ *
+ * @details Events are polled once per frame for all the windows, instead of once per
+ * gl_util::Window::refresh(). Each event is timestamped and dispatched to the queue of
+ * the window it belongs to, and is read by gl_util::Window::popEvent(). Once a window
+ * is attached, its refresh() only swaps buffers.
+ *
+ * @code
+ * gl_util::EventLoop loop;
+ * loop.attach(left);
+ * loop.attach(right);
+ * while(!left.shouldClose()) {
+ *     loop.poll();
+ *     gl_util::Event event;
+ *     while(left.popEvent(event)) { ... }
+ *     // render and refresh windows ...
+ * }
+ * @endcode
+ *
+ * @note Polling and waiting should be done on the main thread, as required by GLFW.
+ * Popping events is thread-safe, e.g. on a render thread.
+ */
+class EventLoop {
+public:
+    /**
+     * @brief Construct a new EventLoop object.
+     */
+    EventLoop();
+
+    /**
+     * @brief Delete copy constructor.
+     */
+    EventLoop(const EventLoop&) = delete;
+
+    /**
+     * @brief Delete assignment constructor.
+     */
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    /**
+     * @brief Destroy the EventLoop object, all the windows are detached.
+     */
+    ~EventLoop();
+
+    /**
+     * @brief Dispatch the events of the window to its queue.
+     *
+     * @note The key, char, mouse button, cursor, scroll, size, focus and close
+     * callbacks of the GLFWwindow are replaced.
+     */
+    void attach(Window& window);
+
+    /**
+     * @brief Stop dispatching the events of the window, its refresh() polls events
+     * again.
+     */
+    void detach(Window& window);
+
+    /**
+     * @brief Process the pending events, and return immediately.
+     */
+    void poll();
+
+    /**
+     * @brief Block until at least one event is received, and process it.
+     */
+    void wait();
+
+    /**
+     * @brief Block until at least one event is received or the timeout elapses.
+     *
+     * @param timeout  The maximum time to wait, in seconds.
+     */
+    void wait(double timeout);
+
+    /**
+     * @brief Wake up the main thread from wait(). This function is thread-safe.
+     */
+    void wakeUp();
+
+    /**
+     * @brief Get the number of poll() and wait() calls, for diagnosis.
+     */
+    uint64_t pumpCount() const;
+
+private:
+    /** The GLFW callbacks, defined in the source file **/
+    struct Callbacks;
+
+    /* Push the event to the queue of the window */
+    static void dispatch(GLFWwindow* window, const Event& event);
+
+    std::vector<Window*> _windows;  ///< The attached windows
+    uint64_t _pump_count;           ///< The number of pumps
+};
+
+GL_UTIL_END
+#endif // GL_UTIL_EVENT_LOOP_H_LF
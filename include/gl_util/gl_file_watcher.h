@@ -0,0 +1,110 @@
+/** -------------------------------------------------------------------------------------
+ *
+ *   				                 OpenGL Utilities
+ *
+ * @file 		gl_file_watcher.h
+ *
+ * @brief 		Notify the changes of files from a background thread.
+ *
+ * @author		Longfei Wang
+ *
+ * @version		1.0.0
+ *
+ * @date		2026/10/16
+ *
+ * @license		MIT
+ *
+ * Copyright (C) 2021-Now Longfei Wang.
+ * ------------------------------------------------------------------------------------*/
+#ifndef GL_UTIL_FILE_WATCHER_H_LF
+#define GL_UTIL_FILE_WATCHER_H_LF
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "gl_util_ns.h"
+
+GL_UTIL_BEGIN
+
+/**
+ * @brief A watcher that calls back when a file is written or replaced.
+ *
+ * @details The parent directory of each file is watched by inotify, so that files
+ * saved by editors through renaming a temporary file are also detected. A background
+ * thread waits for the events, the files are never polled.
+ *
+ * @note Only supported on Linux, watch() fails on the other platforms.
+ */
+class FileWatcher {
+public:
+    /**
+     * @brief The callback with the path of the changed file, called on the watcher
+     * thread. It should be short, and must not call watch() or unwatch().
+     */
+    typedef std::function<void(const std::string& path)> Callback;
+
+    /**
+     * @brief Get the watcher shared by the library, e.g. gl_util::Shader::watch().
+     */
+    static FileWatcher& shared();
+
+    /**
+     * @brief Construct a new FileWatcher object, the thread starts on first watch().
+     */
+    FileWatcher();
+
+    /**
+     * @brief Delete copy constructor.
+     */
+    FileWatcher(const FileWatcher&) = delete;
+
+    /**
+     * @brief Delete assignment constructor.
+     */
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    /**
+     * @brief Stop the thread and remove all the watches.
+     */
+    ~FileWatcher();
+
+    /**
+     * @brief Watch the file.
+     *
+     * @param path  The path of the file, which may not exist yet.
+     * @param callback  The callback once the file is changed.
+     * @return The ID of the watch, 0 if failed.
+     */
+    uint64_t watch(const std::string& path, Callback callback);
+
+    /**
+     * @brief Remove the watch, the callback is not called after returning.
+     */
+    void unwatch(uint64_t id);
+
+private:
+    struct Entry {
+        std::string directory;  ///< The normalized parent directory
+        std::string name;       ///< The file name
+        Callback    callback;   ///< The callback
+    };
+
+    /* Start the thread if not started */
+    bool start();
+
+    /* The loop of the thread */
+    void run();
+
+    int _fd;                    ///< The inotify instance
+    int _wake_fd;               ///< The eventfd to wake up the thread to exit
+    std::thread _thread;        ///< The thread waiting for the events
+    std::mutex  _mutex;         ///< The lock of the entries and directories
+    uint64_t    _next_id;       ///< The ID of next watch
+    std::map<uint64_t, Entry> _entries;     ///< The watches
+    std::map<std::string, int> _directories;///< The watch descriptors of directories
+};
+
+GL_UTIL_END
+#endif // GL_UTIL_FILE_WATCHER_H_LF
@@ -0,0 +1,255 @@
+/** -------------------------------------------------------------------------------------
+ *
+ *   				                 OpenGL Utilities
+ *
+ * @file 		gl_framebuffer.h
+ *
+ * @brief 		A manager for offscreen framebuffer object.
+ *
+ * @author		Longfei Wang
+ *
+ * @version		1.0.0
+ *
+ * @date		2026/10/16
+ *
+ * @license		MIT
+ *
+ * Copyright (C) 2021-Now Longfei Wang.
+ *
+ * --------------------------------------------------------------------------------------
+ * References:
+ * https://learnopengl-cn.github.io/04%20Advanced%20OpenGL/05%20Framebuffers/
+ * https://learnopengl-cn.github.io/04%20Advanced%20OpenGL/11%20Anti%20Aliasing/
+ * ------------------------------------------------------------------------------------*/
+#ifndef GL_UTIL_FRAMEBUFFER_H_LF
+#define GL_UTIL_FRAMEBUFFER_H_LF
+#include <glad/glad.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "gl_util_ns.h"
+
+GL_UTIL_BEGIN
+
+/**
+ * @brief A manager for offscreen render target, i.e. the GL framebuffer object (FBO).
+ *
+ * @details The attachments are configured by addColorAttachment() and
+ * setDepthAttachment(), and then allocated by create(). Rendering goes to this
+ * target between bind() and unbind(), no swap is required.
+ * If the FrameBuffer is multisampled, the attachments cannot be sampled directly, an
+ * explicit resolve() blits them to an internal single-sampled FrameBuffer, whose
+ * textures are returned by colorTexture() and depthTexture().
+ */
+class FrameBuffer {
+public:
+    /**
+     * @brief The storage of an attachment.
+     */
+    enum Storage {
+        STORAGE_TEXTURE,        ///< Texture, can be sampled in shader.
+        STORAGE_RENDERBUFFER    ///< Renderbuffer, render only, generally faster.
+    };
+
+    /**
+     * @brief Construct a new FrameBuffer object.
+     *
+     * @param width  The width of the render target.
+     * @param height  The height of the render target.
+     * @param samples  The number of MSAA samples, 0 denotes no multisample.
+     */
+    FrameBuffer(uint16_t width, uint16_t height, uint8_t samples = 0);
+
+    /**
+     * @brief Delete copy constructor.
+     *
+     * @note FrameBuffer owns the GL framebuffer and attachments, so it cannot be copied.
+     */
+    FrameBuffer(const FrameBuffer&) = delete;
+
+    /**
+     * @brief Delete assignment constructor.
+     */
+    FrameBuffer& operator=(const FrameBuffer&) = delete;
+
+    /**
+     * @brief Move constructor, the GL objects are taken from the other FrameBuffer,
+     * which is left empty and not created.
+     */
+    FrameBuffer(FrameBuffer&& other) noexcept;
+
+    /**
+     * @brief Move assignment, the GL objects of this FrameBuffer are deleted first.
+     */
+    FrameBuffer& operator=(FrameBuffer&& other) noexcept;
+
+    /**
+     * @brief Destroy the FrameBuffer object, all the GL objects will be deleted.
+     */
+    ~FrameBuffer();
+
+    /**
+     * @brief Add a color attachment, attached to GL_COLOR_ATTACHMENT0 + index in the
+     * calling order.
+     *
+     * @param internal_format  The sized internal format, such as GL_RGBA8, GL_RGB8,
+     * GL_RGBA16F, GL_RGBA32F, GL_R32F.
+     * @param storage  The storage of the attachment.
+     * @return
+     *   @retval true  If the attachment is added.
+     *   @retval false Otherwise, e.g. the FrameBuffer has been created.
+     */
+    bool addColorAttachment(GLenum internal_format = GL_RGBA8,
+                            Storage storage = STORAGE_TEXTURE);
+
+    /**
+     * @brief Set the depth (or depth-stencil) attachment.
+     *
+     * @param internal_format  The sized internal format, such as GL_DEPTH_COMPONENT16,
+     * GL_DEPTH_COMPONENT24, GL_DEPTH_COMPONENT32F, GL_DEPTH24_STENCIL8.
+     * @param storage  The storage of the attachment. Use STORAGE_TEXTURE if the depth
+     * is going to be sampled or read back.
+     * @return
+     *   @retval true  If the attachment is set.
+     *   @retval false Otherwise, e.g. the FrameBuffer has been created.
+     */
+    bool setDepthAttachment(GLenum internal_format = GL_DEPTH_COMPONENT24,
+                            Storage storage = STORAGE_RENDERBUFFER);
+
+    /**
+     * @brief Allocate the framebuffer and its attachments.
+     *
+     * @note If no color attachment is added, a GL_RGBA8 texture is added defaultly.
+     *
+     * @return
+     *   @retval true  If the framebuffer is complete.
+     *   @retval false Otherwise.
+     */
+    bool create();
+
+    /**
+     * @brief Resize the render target.
+     *
+     * @details The GL framebuffer, textures and renderbuffers are reused, only their
+     * storage is re-specified. Nothing is done if the size is not changed.
+     *
+     * @param width  The new width.
+     * @param height  The new height.
+     * @return
+     *   @retval true  If the framebuffer is complete after resizing.
+     *   @retval false Otherwise.
+     */
+    bool resize(uint16_t width, uint16_t height);
+
+    /**
+     * @brief Bind the framebuffer as the render target, and set the viewport to it.
+     */
+    void bind();
+
+    /**
+     * @brief Bind the default framebuffer of current context.
+     */
+    void unbind();
+
+    /**
+     * @brief Clear the attachments of the framebuffer.
+     *
+     * @note This function will bind current framebuffer.
+     */
+    void clear(float R = 0.f, float G = 0.f, float B = 0.f, float A = 0.f);
+
+    /**
+     * @brief Resolve the multisampled attachments to the internal single-sampled
+     * FrameBuffer by blitting.
+     *
+     * @note Nothing is done if the framebuffer is not multisampled.
+     */
+    void resolve();
+
+    /**
+     * @brief Blit the color attachment to another framebuffer, e.g. the default
+     * framebuffer 0 of a gl_util::Window.
+     *
+     * @note A multisampled FrameBuffer is resolved first if the destination region
+     * is of another size, since a scaled blit cannot read the samples.
+     *
+     * @param dst_fbo  The destination framebuffer.
+     * @param dst_width  The width of destination region.
+     * @param dst_height  The height of destination region.
+     * @param index  The index of the color attachment.
+     * @param filter  GL_NEAREST or GL_LINEAR.
+     */
+    void blitTo(GLuint dst_fbo, uint16_t dst_width, uint16_t dst_height,
+                uint8_t index = 0, GLenum filter = GL_LINEAR);
+
+    /**
+     * @brief Get the color texture that can be sampled.
+     *
+     * @note For multisampled FrameBuffer, the texture of resolved target is returned,
+     * so call resolve() first.
+     *
+     * @param index  The index of the color attachment.
+     * @return The GL texture, 0 if the attachment is not backed by a texture.
+     */
+    GLuint colorTexture(uint8_t index = 0) const;
+
+    /**
+     * @brief Get the depth texture that can be sampled.
+     *
+     * @return The GL texture, 0 if the depth attachment is not backed by a texture.
+     */
+    GLuint depthTexture() const;
+
+    /**
+     * @brief Bind the color texture to the given texture unit for sampling.
+     */
+    void bindColorTexture(uint8_t unit, uint8_t index = 0) const;
+
+    /**
+     * @brief Get the GL framebuffer object.
+     */
+    GLuint ID() const;
+
+    /**
+     * @brief Get the framebuffer that holds the sampleable results, i.e. the resolve
+     * target for multisampled FrameBuffer, or the FrameBuffer itself otherwise.
+     */
+    GLuint resolvedID() const;
+
+    uint16_t width() const;     ///< The width of the render target.
+    uint16_t height() const;    ///< The height of the render target.
+    uint8_t samples() const;    ///< The number of MSAA samples.
+    uint8_t colorCount() const; ///< The number of color attachments.
+
+private:
+    /** The description and the GL object of an attachment **/
+    struct Attachment {
+        GLenum  internal_format;
+        Storage storage;
+        GLuint  object;
+    };
+
+    /* Allocate the storage of an attachment with current size */
+    void allocate(Attachment& attachment);
+    /* Attach an attachment to the framebuffer */
+    void attach(const Attachment& attachment, GLenum attachment_point);
+    /* Check whether the framebuffer is complete */
+    bool checkStatus() const;
+    /* Exchange the GL objects with the other FrameBuffer */
+    void swap(FrameBuffer& other) noexcept;
+
+    uint16_t _width;            ///< The width of the render target
+    uint16_t _height;           ///< The height of the render target
+    uint8_t  _samples;          ///< The number of MSAA samples
+    GLuint   _fbo;              ///< The framebuffer object
+    bool     _has_created;      ///< Whether the framebuffer is created
+
+    std::vector<Attachment> _colors;    ///< The color attachments
+    Attachment _depth;                  ///< The depth attachment
+    bool       _has_depth;              ///< Whether the depth attachment is set
+
+    std::unique_ptr<FrameBuffer> _resolved; ///< The resolve target for MSAA
+};
+
+GL_UTIL_END
+#endif // GL_UTIL_FRAMEBUFFER_H_LF
@@ -0,0 +1,218 @@
+/** -------------------------------------------------------------------------------------
+ *
+ *   				                 OpenGL Utilities
+ *
+ * @file 		gl_profiler.h
+ *
+ * @brief 		A CPU/GPU frame profiler based on GL timer queries.
+ *
+ * @author		Longfei Wang
+ *
+ * @version		1.0.0
+ *
+ * @date		2026/10/16
+ *
+ * @license		MIT
+ *
+ * Copyright (C) 2021-Now Longfei Wang.
+ * ------------------------------------------------------------------------------------*/
+#ifndef GL_UTIL_PROFILER_H_LF
+#define GL_UTIL_PROFILER_H_LF
+#include <glad/glad.h>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include "gl_util_ns.h"
+
+GL_UTIL_BEGIN
+
+/**
+ * @brief The timing of a named zone in a frame.
+ */
+struct ZoneTiming {
+    const char* name;   ///< The name of the zone
+    uint8_t depth;      ///< The nesting depth, 0 for the outermost zones
+    double cpu_ms;      ///< The CPU time in milliseconds
+    double gpu_ms;      ///< The GPU time in milliseconds, negative if unavailable
+};
+
+/**
+ * @brief The timing of a frame.
+ */
+struct FrameTiming {
+    uint64_t index;     ///< The index of the frame
+    double cpu_ms;      ///< The CPU time from beginFrame() to endFrame()
+    double gpu_ms;      ///< The GPU time from beginFrame() to endFrame(), negative
+                        ///< if unavailable
+    std::vector<ZoneTiming> zones;  ///< The zones in the order they begin
+};
+
+/**
+ * @brief A frame profiler that measures both CPU and GPU time of frames and zones.
+ *
+ * @details GPU time is measured by GL_TIMESTAMP queries, which can be nested, unlike
+ * GL_TIME_ELAPSED. The results of a frame are collected several frames later, once
+ * the queries are available, so the profiler never waits for the GPU. The query
+ * objects are recycled in a pool.
+ *
+ * The frame zone is recorded automatically between gl_util::Window::clear() and
+ * gl_util::Window::refresh() once the profiler is set by
+ * gl_util::Window::setProfiler(). Otherwise, call beginFrame() and endFrame().
+ *
+ * @code
+ * gl_util::Profiler profiler;
+ * window.setProfiler(&profiler);
+ * while(!window.shouldClose()) {
+ *     window.clear();
+ *     {
+ *         gl_util::Profiler::Scope scope(profiler, "scene");
+ *         // draw ...
+ *     }
+ *     window.refresh();
+ *     if(profiler.historySize() > 0) {
+ *         printf("GPU: %f ms\n", profiler.history(0).gpu_ms);
+ *     }
+ * }
+ * @endcode
+ *
+ * @note Query objects are not shared between contexts, so a Profiler should be used
+ * with one context only.
+ */
+class Profiler {
+public:
+    /**
+     * @brief A zone that lasts for the scope.
+     */
+    class Scope {
+    public:
+        /**
+         * @brief Begin a zone.
+         *
+         * @param name  The name of the zone, which should outlive the profiler, e.g. a
+         * string literal.
+         */
+        Scope(Profiler& profiler, const char* name);
+
+        /**
+         * @brief End the zone.
+         */
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        Profiler& _profiler;
+    };
+
+    /**
+     * @brief Construct a new Profiler object.
+     *
+     * @param history_size  The number of the latest completed frames to keep.
+     * @param max_latency  The maximum number of frames waiting for GPU results. The
+     * GPU results of older frames are given up, instead of stalling.
+     */
+    Profiler(size_t history_size = 120, uint8_t max_latency = 4);
+
+    /**
+     * @brief Delete copy constructor.
+     */
+    Profiler(const Profiler&) = delete;
+
+    /**
+     * @brief Delete assignment constructor.
+     */
+    Profiler& operator=(const Profiler&) = delete;
+
+    /**
+     * @brief Destroy the Profiler object, the query objects are deleted.
+     *
+     * @note The context that the profiler works with should be current.
+     */
+    ~Profiler();
+
+    /**
+     * @brief Enable or disable profiling. Disabled profiler issues no GL call.
+     *
+     * @note Disabling between beginFrame() and endFrame() ends the frame.
+     */
+    void setEnabled(bool enabled);
+
+    /**
+     * @brief Begin a frame.
+     */
+    void beginFrame();
+
+    /**
+     * @brief End current frame, and collect the results of previous frames if the GPU
+     * has finished them.
+     */
+    void endFrame();
+
+    /**
+     * @brief Begin a named zone in current frame. Zones can be nested.
+     *
+     * @param name  The name of the zone, which should outlive the profiler.
+     */
+    void beginZone(const char* name);
+
+    /**
+     * @brief End the latest begun zone.
+     */
+    void endZone();
+
+    /**
+     * @brief Get the number of the completed frames kept in history.
+     */
+    size_t historySize() const;
+
+    /**
+     * @brief Get a completed frame.
+     *
+     * @param age  0 for the latest completed frame, 1 for the one before, and so on.
+     */
+    const FrameTiming& history(size_t age) const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    /** A zone waiting for GPU results **/
+    struct PendingZone {
+        const char* name;
+        uint8_t depth;
+        Clock::time_point cpu_begin;
+        Clock::time_point cpu_end;
+        GLuint query_begin;
+        GLuint query_end;
+    };
+
+    /** A frame waiting for GPU results, the first zone is the frame itself **/
+    struct PendingFrame {
+        uint64_t index;
+        std::vector<PendingZone> zones;
+    };
+
+    /* Get a query object from the pool */
+    GLuint acquireQuery();
+    /* Collect the frames whose results are available */
+    void collect();
+    /* Move a frame to history, reading the GPU results if 'has_gpu' */
+    void complete(PendingFrame& frame, bool has_gpu);
+
+    size_t  _history_size;      ///< The capacity of history
+    uint8_t _max_latency;       ///< The maximum number of pending frames
+    bool    _enabled;           ///< Whether profiling is enabled
+    bool    _in_frame;          ///< Whether a frame is begun
+    uint64_t _frame_index;      ///< The index of next frame
+
+    std::vector<GLuint> _free_queries;      ///< The pool of query objects
+    std::vector<size_t> _zone_stack;        ///< The begun zones of current frame
+    PendingFrame _current;                  ///< Current frame
+    std::deque<PendingFrame> _pending;      ///< Frames waiting for GPU results
+    std::deque<FrameTiming>  _history;      ///< Completed frames, latest at front
+};
+
+GL_UTIL_END
+#endif // GL_UTIL_PROFILER_H_LF
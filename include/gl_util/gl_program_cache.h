@@ -0,0 +1,109 @@
+/** -------------------------------------------------------------------------------------
+ *
+ *   				                 OpenGL Utilities
+ *
+ * @file 		gl_program_cache.h
+ *
+ * @brief 		An on-disk cache of linked program binaries.
+ *
+ * @author		Longfei Wang
+ *
+ * @version		1.0.0
+ *
+ * @date		2026/10/16
+ *
+ * @license		MIT
+ *
+ * Copyright (C) 2021-Now Longfei Wang.
+ * ------------------------------------------------------------------------------------*/
+#ifndef GL_UTIL_PROGRAM_CACHE_H_LF
+#define GL_UTIL_PROGRAM_CACHE_H_LF
+#include <glad/glad.h>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <initializer_list>
+#include <vector>
+#include "gl_util_ns.h"
+
+GL_UTIL_BEGIN
+
+/**
+ * @brief An on-disk cache of program binaries, used by gl_util::Shader::load() to
+ * skip compiling and linking the GLSL sources on later launches.
+ *
+ * @details Each binary is stored as '<directory>/<key>.bin', where the key is a
+ * hash of all the (preprocessed) sources and the GL vendor, renderer and version
+ * strings, so a driver update never loads a stale binary. A binary rejected by the
+ * driver is removed, and the program is compiled from the sources instead.
+ *
+ * Files are written to a temporary file and then renamed, so concurrent processes
+ * never read a partial file.
+ *
+ * @code
+ * gl_util::ProgramBinaryCache::setDirectory("./shader_cache");
+ * gl_util::Shader shader;
+ * shader.load("a.vs", "a.fs");    // Linked from source once, from binary later.
+ * @endcode
+ *
+ * @note The cache is disabled until a directory is set.
+ */
+class ProgramBinaryCache {
+public:
+    /**
+     * @brief Set the directory of the cache, which is created if it does not exist.
+     *
+     * @param directory  The directory, an empty string disables the cache.
+     * @return
+     *   @retval true  The cache is enabled or disabled as requested.
+     *   @retval false The directory cannot be created, and the cache is disabled.
+     */
+    static bool setDirectory(const std::string& directory);
+
+    /**
+     * @brief Get the directory of the cache, empty if the cache is disabled.
+     */
+    static std::string directory();
+
+    /**
+     * @brief Compute the key of the program from its sources and current driver.
+     *
+     * @param sources  The sources of all the stages, in a fixed order.
+     */
+    static uint64_t key(std::initializer_list<std::string_view> sources);
+
+    /**
+     * @brief Compute the key of the program from its sources and current driver.
+     *
+     * @remark This is an overloaded function, provided for a varying number of stages.
+     */
+    static uint64_t key(const std::vector<std::string_view>& sources);
+
+    /**
+     * @brief Load the program from the cached binary.
+     *
+     * @param program  The program to load into.
+     * @param key  The key from key().
+     * @return
+     *   @retval true  The program is linked from the binary.
+     *   @retval false The cache is disabled, or no binary is accepted.
+     */
+    static bool load(GLuint program, uint64_t key);
+
+    /**
+     * @brief Store the binary of the linked program.
+     *
+     * @note The GL_PROGRAM_BINARY_RETRIEVABLE_HINT of the program should be set
+     * before linking, see prepare().
+     */
+    static bool store(GLuint program, uint64_t key);
+
+    /**
+     * @brief Set the hint to retrieve the binary of the program before linking it,
+     * if the cache is enabled.
+     */
+    static void prepare(GLuint program);
+};
+
+GL_UTIL_END
+#endif // GL_UTIL_PROGRAM_CACHE_H_LF
@@ -0,0 +1,145 @@
+/** -------------------------------------------------------------------------------------
+ *
+ *   				                 OpenGL Utilities
+ *
+ * @file 		gl_program_pipeline.h
+ *
+ * @brief 		Combine the stages of separable programs without linking.
+ *
+ * @author		Longfei Wang
+ *
+ * @version		1.0.0
+ *
+ * @date		2026/10/16
+ *
+ * @license		MIT
+ *
+ * Copyright (C) 2021-Now Longfei Wang.
+ * ------------------------------------------------------------------------------------*/
+#ifndef GL_UTIL_PROGRAM_PIPELINE_H_LF
+#define GL_UTIL_PROGRAM_PIPELINE_H_LF
+#include <glad/glad.h>
+#include <cstdint>
+#include <vector>
+#include "gl_util_ns.h"
+
+GL_UTIL_BEGIN
+
+class Shader;
+
+/**
+ * @brief A program pipeline object, which takes each stage from a separable program.
+ *
+ * @details A vertex program shared by many fragment programs is linked once, instead
+ * of once per combination, and the combinations are switched by binding pipelines.
+ * @code
+ * gl_util::Shader vertex, lit, unlit;
+ * vertex.setSeparable();
+ * lit.setSeparable();
+ * unlit.setSeparable();
+ * vertex.loadStages({ { GL_VERTEX_SHADER, "mesh.vs" } });
+ * lit.loadStages({ { GL_FRAGMENT_SHADER, "lit.fs" } });
+ * unlit.loadStages({ { GL_FRAGMENT_SHADER, "unlit.fs" } });
+ *
+ * gl_util::ProgramPipeline pipeline;
+ * pipeline.attach(vertex);
+ * pipeline.attach(lit);
+ * pipeline.bind();
+ * @endcode
+ *
+ * @note Uniforms are set per program, e.g. by the handles from
+ * gl_util::Shader::uniform<T>(), which do not need the program in use.
+ * @note The vertex outputs should match the fragment inputs by location, and the
+ * vertex program may need to redeclare the 'gl_PerVertex' block.
+ * @note The programs should outlive the pipeline, and be attached again once moved.
+ */
+class ProgramPipeline {
+public:
+    /**
+     * @brief Construct a new ProgramPipeline object.
+     */
+    ProgramPipeline();
+
+    /**
+     * @brief Delete copy constructor.
+     */
+    ProgramPipeline(const ProgramPipeline&) = delete;
+
+    /**
+     * @brief Delete assignment constructor.
+     */
+    ProgramPipeline& operator=(const ProgramPipeline&) = delete;
+
+    /**
+     * @brief Move constructor, the pipeline and the attached stages are taken from the
+     * other ProgramPipeline, which is left without pipeline.
+     */
+    ProgramPipeline(ProgramPipeline&& other) noexcept;
+
+    /**
+     * @brief Move assignment, the pipeline of this ProgramPipeline is deleted first.
+     */
+    ProgramPipeline& operator=(ProgramPipeline&& other) noexcept;
+
+    /**
+     * @brief Destroy the ProgramPipeline object, the programs are not deleted.
+     */
+    ~ProgramPipeline();
+
+    /**
+     * @brief Use the stages of the separable program, replacing the stages attached
+     * before. The stages follow the program when it is reloaded.
+     *
+     * @param shader  The separable program.
+     * @param stages  The stage bits to use, masked by the stages of the program.
+     * @return
+     *   @retval true  Succeed.
+     *   @retval false The program is not separable.
+     */
+    bool attach(Shader& shader, GLbitfield stages = GL_ALL_SHADER_BITS);
+
+    /**
+     * @brief Remove the stages from the pipeline.
+     */
+    void detach(GLbitfield stages);
+
+    /**
+     * @brief Check whether the stages can run together, and log the reason if not.
+     *
+     * @note Should be called after bind() in debug builds only, since the check is
+     * expensive.
+     */
+    bool validate();
+
+    /**
+     * @brief Bind the pipeline before rendering, instead of gl_util::Shader::use().
+     *
+     * @details The attached programs are reloaded and swapped first, as use() does.
+     */
+    void bind();
+
+    /**
+     * @brief Get the GL program pipeline object.
+     */
+    GLuint ID() const;
+
+private:
+    /** The stages taken from a program **/
+    struct Stage {
+        Shader*    shader;      ///< The program
+        GLbitfield bits;        ///< The stages taken from the program
+        uint32_t   generation;  ///< The generation of the program when attached
+    };
+
+    /* Apply the stages of the program by glUseProgramStages() */
+    void apply(Stage& stage);
+
+    /* Exchange the pipelines with the other ProgramPipeline */
+    void swap(ProgramPipeline& other) noexcept;
+
+    GLuint _pipeline;               ///< The program pipeline object
+    std::vector<Stage> _stages;     ///< The attached stages
+};
+
+GL_UTIL_END
+#endif // GL_UTIL_PROGRAM_PIPELINE_H_LF
@@ -19,14 +19,37 @@
  * --------------------------------------------------------------------------------------
  * Change History:                        
  * 
+ * 2026.10.16 Add unproject() to convert depth buffer to organized point cloud.
+ * 2026.10.16 Add batch interfaces of cvt2RealDepth() for whole depth buffers.
  * ------------------------------------------------------------------------------------*/
 #ifndef GL_UTIL_PROJECTION_H_LF
 #define GL_UTIL_PROJECTION_H_LF
 #include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
 #include "gl_util_ns.h"
 
 GL_UTIL_BEGIN
 
+/**
+ * @brief A 3D point w.r.t camera frame, i.e. x-right, y-down and z-forward.
+ */
+struct PointXYZ {
+    float x;
+    float y;
+    float z;
+};
+
+/**
+ * @brief A 3D point w.r.t camera frame with color, 16 bytes per point.
+ */
+struct PointXYZRGB {
+    float x;
+    float y;
+    float z;
+    uint32_t rgba;  ///< The color packed as R, G, B, A bytes in memory order
+};
+
 /**
  * @brief Construct the projection matrix for OpenGL. 
  * The OpenGL projection matrix is consist of clipping and NDC transform. 
@@ -85,6 +108,140 @@ public:
      */
     float cvt2RealDepth(float z_buf) const;
 
+    /**
+     * @brief Convert a whole depth buffer read as GL_FLOAT to real depth.
+     * 
+     * @details The conversion is vectorized by SSE2/AVX2/NEON, and the instruction 
+     * set is selected at runtime according to the CPU.
+     * 
+     * @param[in] in  The depth buffer.
+     * @param[out] out  The real depth, can be the same as 'in'.
+     * @param[in] n  The number of depth values.
+     * @param[in] threads  The number of threads to split the buffer, 0 denotes all 
+     * the hardware threads.
+     */
+    void cvt2RealDepth(const float* in, float* out, size_t n, unsigned threads = 1) const;
+
+    /**
+     * @brief Convert a whole depth buffer read as GL_UNSIGNED_SHORT, e.g. from 
+     * GL_DEPTH_COMPONENT16, to real depth.
+     * 
+     * @remark This is an overloaded function, provided for convenience. 
+     */
+    void cvt2RealDepth(const uint16_t* in, float* out, size_t n, 
+                       unsigned threads = 1) const;
+
+    /**
+     * @brief Convert a whole depth buffer read as unsigned int to real depth.
+     * 
+     * @remark This is an overloaded function, provided for convenience. 
+     * 
+     * @param[in] depth_bits  The number of the most significant bits that hold the 
+     * depth value. It is 32 for GL_UNSIGNED_INT, and 24 for GL_UNSIGNED_INT_24_8 (the 
+     * packed GL_DEPTH24_STENCIL8). Nothing is converted if it is not 1 to 32.
+     */
+    void cvt2RealDepth(const uint32_t* in, float* out, size_t n, 
+                       uint8_t depth_bits = 32, unsigned threads = 1) const;
+
+    /**
+     * @brief Convert a 2D depth buffer with row strides to real depth.
+     * 
+     * @remark This is an overloaded function, provided for convenience. 
+     * 
+     * @param[in] in  The depth buffer.
+     * @param[in] in_stride  The number of elements between two rows of 'in'.
+     * @param[out] out  The real depth.
+     * @param[in] out_stride  The number of elements between two rows of 'out'.
+     * @param[in] width  The number of columns to convert.
+     * @param[in] height  The number of rows to convert.
+     * @param[in] threads  The number of threads to split the rows.
+     */
+    void cvt2RealDepth(const float* in, size_t in_stride, float* out, size_t out_stride,
+                       uint16_t width, uint16_t height, unsigned threads = 1) const;
+
+    /**
+     * @brief Convert a 2D depth buffer of GL_UNSIGNED_SHORT to real depth.
+     * 
+     * @remark This is an overloaded function, provided for convenience. 
+     */
+    void cvt2RealDepth(const uint16_t* in, size_t in_stride, float* out, 
+                       size_t out_stride, uint16_t width, uint16_t height, 
+                       unsigned threads = 1) const;
+
+    /**
+     * @brief Convert a 2D depth buffer of unsigned int to real depth.
+     * 
+     * @remark This is an overloaded function, provided for convenience. 
+     */
+    void cvt2RealDepth(const uint32_t* in, size_t in_stride, float* out, 
+                       size_t out_stride, uint16_t width, uint16_t height, 
+                       uint8_t depth_bits = 32, unsigned threads = 1) const;
+
+    /**
+     * @brief Unproject a depth buffer of GL_FLOAT to an organized point cloud.
+     * 
+     * @details The linearization and the back-projection are fused row by row, so 
+     * the depth buffer is read only once. The back-projection uses the intrinsics 
+     * (fxy, cx, cy), and is vectorized by SSE2/NEON.
+     * 
+     * @param[in] depth  The w x h depth buffer, as read by glReadPixels, i.e. the first
+     * row is the bottom of the image.
+     * @param[out] cloud  The w x h points, organized as the camera image, i.e. the 
+     * first row is the top of the image. The points on the far plane (background) are
+     * set to NaN.
+     * @param[in] threads  The number of threads to split the rows, 0 denotes all the 
+     * hardware threads.
+     */
+    void unproject(const float* depth, PointXYZ* cloud, unsigned threads = 1) const;
+
+    /**
+     * @brief Unproject a depth buffer of GL_UNSIGNED_SHORT to a point cloud.
+     * 
+     * @remark This is an overloaded function, provided for convenience. 
+     */
+    void unproject(const uint16_t* depth, PointXYZ* cloud, unsigned threads = 1) const;
+
+    /**
+     * @brief Unproject a depth buffer of unsigned int to a point cloud.
+     * 
+     * @remark This is an overloaded function, provided for convenience. 
+     * 
+     * @param[in] depth_bits  32 for GL_UNSIGNED_INT, and 24 for GL_UNSIGNED_INT_24_8.
+     * Nothing is unprojected if it is not 1 to 32.
+     */
+    void unproject(const uint32_t* depth, PointXYZ* cloud, uint8_t depth_bits = 32, 
+                   unsigned threads = 1) const;
+
+    /**
+     * @brief Unproject a depth buffer of GL_FLOAT to a colored point cloud.
+     * 
+     * @remark This is an overloaded function, provided for convenience. 
+     * 
+     * @param[in] color  The w x h color image of GL_UNSIGNED_BYTE, with the same row 
+     * order as the depth buffer.
+     * @param[in] channels  3 for GL_RGB, 4 for GL_RGBA. Nothing is unprojected
+     * otherwise.
+     */
+    void unproject(const float* depth, const uint8_t* color, uint8_t channels,
+                   PointXYZRGB* cloud, unsigned threads = 1) const;
+
+    /**
+     * @brief Unproject a depth buffer of GL_UNSIGNED_SHORT to a colored point cloud.
+     * 
+     * @remark This is an overloaded function, provided for convenience. 
+     */
+    void unproject(const uint16_t* depth, const uint8_t* color, uint8_t channels,
+                   PointXYZRGB* cloud, unsigned threads = 1) const;
+
+    /**
+     * @brief Unproject a depth buffer of unsigned int to a colored point cloud.
+     * 
+     * @remark This is an overloaded function, provided for convenience. 
+     */
+    void unproject(const uint32_t* depth, const uint8_t* color, uint8_t channels,
+                   PointXYZRGB* cloud, uint8_t depth_bits = 32, 
+                   unsigned threads = 1) const;
+
     /**
      * @brief Return a new gl_util::Projection object which for the Near-Eye Display (NED)
      * that displays the camera images.
@@ -109,6 +266,8 @@ public:
 private:
     /** Calculate projection matrix **/
     void calcProjection();
+    /** The real depth beyond which a point is regarded as background **/
+    float farCut() const;
 
     float _z_near;  ///< The distance of near plane
     float _z_far;   ///< The distance of far plane
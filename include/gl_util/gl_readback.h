@@ -0,0 +1,183 @@
+/** -------------------------------------------------------------------------------------
+ *
+ *   				                 OpenGL Utilities
+ *
+ * @file 		gl_readback.h
+ *
+ * @brief 		Asynchronous pixel readback by a ring of pixel pack buffers.
+ *
+ * @author		Longfei Wang
+ *
+ * @version		1.0.0
+ *
+ * @date		2026/10/16
+ *
+ * @license		MIT
+ *
+ * Copyright (C) 2021-Now Longfei Wang.
+ * ------------------------------------------------------------------------------------*/
+#ifndef GL_UTIL_READBACK_H_LF
+#define GL_UTIL_READBACK_H_LF
+#include <glad/glad.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "gl_util_ns.h"
+
+GL_UTIL_BEGIN
+
+class Window;
+class FrameBuffer;
+
+/**
+ * @brief Read the rendered pixels back to CPU without stalling the render thread.
+ *
+ * @details Each read() issues glReadPixels into the next pixel pack buffer (PBO) of
+ * an N-deep ring, followed by a fence. Since the PBO is the destination, glReadPixels
+ * returns immediately and the transfer is done by GPU asynchronously. tryFetch()
+ * polls the fence of the oldest queued transfer, and maps the PBO only when the GPU
+ * has finished, so no call ever waits for the GPU.
+ *
+ * A typical loop:
+ * @code
+ * gl_util::AsyncReadback reader(w, h);
+ * reader.attach(window);
+ * while(...) {
+ *     // render ...
+ *     reader.read();
+ *     gl_util::AsyncReadback::Frame frame;
+ *     while(reader.tryFetch(frame)) {
+ *         consume(frame.data, frame.size);
+ *     }
+ *     window.refresh();
+ * }
+ * @endcode
+ *
+ * @note All the calls should be made with the context that reads the pixels current.
+ */
+class AsyncReadback {
+public:
+    /**
+     * @brief A CPU view to a fetched frame.
+     *
+     * @note The data is valid until the next call of tryFetch() or release().
+     */
+    struct Frame {
+        const void* data;   ///< The mapped pixels, rows are tightly packed.
+        size_t   size;      ///< The size of data in bytes.
+        uint16_t width;     ///< The width of the frame.
+        uint16_t height;    ///< The height of the frame.
+        uint64_t index;     ///< The sequence number of the read() that queued it.
+    };
+
+    /**
+     * @brief Construct a new AsyncReadback object.
+     *
+     * @param width  The width of the region to read.
+     * @param height  The height of the region to read.
+     * @param format  The pixel format, such as GL_RGBA, GL_RGB, GL_RED,
+     * GL_DEPTH_COMPONENT.
+     * @param type  The pixel type, such as GL_UNSIGNED_BYTE, GL_FLOAT.
+     * @param depth  The number of PBOs in the ring, i.e. the number of transfers that
+     * can be in flight.
+     */
+    AsyncReadback(uint16_t width, uint16_t height, GLenum format = GL_RGBA,
+                  GLenum type = GL_UNSIGNED_BYTE, uint8_t depth = 3);
+
+    /**
+     * @brief Delete copy constructor.
+     */
+    AsyncReadback(const AsyncReadback&) = delete;
+
+    /**
+     * @brief Delete assignment constructor.
+     */
+    AsyncReadback& operator=(const AsyncReadback&) = delete;
+
+    /**
+     * @brief Destroy the AsyncReadback object, the PBOs and fences are deleted.
+     */
+    ~AsyncReadback();
+
+    /**
+     * @brief Read from the back buffer of the default framebuffer of the window.
+     *
+     * @note The window should be activated when calling read().
+     */
+    void attach(const Window& window);
+
+    /**
+     * @brief Read from an offscreen FrameBuffer.
+     *
+     * @note For multisampled FrameBuffer, the resolve target is read, thus
+     * gl_util::FrameBuffer::resolve() should be called before read().
+     *
+     * @param framebuffer  The FrameBuffer to read, which should be created.
+     * @param index  The index of color attachment. Ignored if the format is
+     * GL_DEPTH_COMPONENT.
+     * @return
+     *   @retval true  If attached.
+     *   @retval false If the FrameBuffer is not created, or has no such color
+     *   attachment. The source is not changed.
+     */
+    bool attach(const FrameBuffer& framebuffer, uint8_t index = 0);
+
+    /**
+     * @brief Queue the transfer of current pixels into the next PBO of the ring.
+     *
+     * @return
+     *   @retval true  If the transfer is queued.
+     *   @retval false If all the PBOs are in flight (the frame is dropped instead of
+     *   stalling), or nothing is attached.
+     */
+    bool read();
+
+    /**
+     * @brief Fetch the oldest queued frame if the GPU has finished the transfer.
+     *
+     * @details The previously fetched frame is released first.
+     *
+     * @param[out] frame  The view to the fetched frame.
+     * @return
+     *   @retval true  If a frame is fetched.
+     *   @retval false If no transfer is queued or the oldest one is not finished yet.
+     */
+    bool tryFetch(Frame& frame);
+
+    /**
+     * @brief Unmap the fetched frame, so that its PBO can be reused by read().
+     */
+    void release();
+
+    /**
+     * @brief Get the number of transfers that are queued but not fetched.
+     */
+    size_t pending() const;
+
+private:
+    /** A slot of the ring **/
+    struct Slot {
+        GLuint   pbo;
+        GLsync   fence;
+        uint64_t index;
+    };
+
+    uint16_t _width;        ///< The width of the region to read
+    uint16_t _height;       ///< The height of the region to read
+    GLenum   _format;       ///< The pixel format
+    GLenum   _type;         ///< The pixel type
+    size_t   _size;         ///< The size of a frame in bytes
+
+    GLuint   _src_fbo;      ///< The framebuffer to read
+    GLenum   _src_buffer;   ///< The buffer to read of the framebuffer
+    bool     _has_source;   ///< Whether a source is attached
+
+    std::vector<Slot> _slots;   ///< The ring of PBOs
+    size_t   _head;         ///< The slot to write next
+    size_t   _count;        ///< The number of queued slots
+    uint64_t _read_count;   ///< The number of the read() calls that succeeded
+    bool     _is_mapped;    ///< Whether the oldest slot is mapped
+};
+
+GL_UTIL_END
+#endif // GL_UTIL_READBACK_H_LF
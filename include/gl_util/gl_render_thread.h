@@ -0,0 +1,104 @@
+/** -------------------------------------------------------------------------------------
+ *
+ *   				                 OpenGL Utilities
+ *
+ * @file 		gl_render_thread.h
+ *
+ * @brief 		A dedicated thread that owns a window context and runs render tasks.
+ *
+ * @author		Longfei Wang
+ *
+ * @version		1.0.0
+ *
+ * @date		2026/10/16
+ *
+ * @license		MIT
+ *
+ * Copyright (C) 2021-Now Longfei Wang.
+ * ------------------------------------------------------------------------------------*/
+#ifndef GL_UTIL_RENDER_THREAD_H_LF
+#define GL_UTIL_RENDER_THREAD_H_LF
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include "gl_util_ns.h"
+
+struct GLFWwindow;
+
+GL_UTIL_BEGIN
+
+/**
+ * @brief A thread that makes the context of a window current, and then runs the
+ * submitted tasks in order until it is destroyed.
+ *
+ * @details Since a context can only be current in one thread, each window with a
+ * RenderThread renders and swaps (including the vsync wait) in parallel with the
+ * other windows.
+ *
+ * @note Generally, there is no need to use this class directly, see
+ * gl_util::Window::startRenderThread().
+ */
+class RenderThread {
+public:
+    /**
+     * @brief Start the thread, and make the context of the window current on it.
+     *
+     * @note The context should not be current on any other thread.
+     */
+    RenderThread(GLFWwindow* window);
+
+    /**
+     * @brief Delete copy constructor.
+     */
+    RenderThread(const RenderThread&) = delete;
+
+    /**
+     * @brief Delete assignment constructor.
+     */
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    /**
+     * @brief Run the remaining tasks, release the context and join the thread.
+     */
+    ~RenderThread();
+
+    /**
+     * @brief Submit a task to run on the thread.
+     *
+     * @param task  The task.
+     * @return The future that becomes ready when the task is done, exceptions thrown
+     * by the task are rethrown by std::future::get().
+     */
+    std::future<void> submit(std::function<void()> task);
+
+    /**
+     * @brief Block until all the submitted tasks are done.
+     *
+     * @note Calling this function on the render thread itself returns immediately.
+     */
+    void wait();
+
+    /**
+     * @brief Check whether the calling thread is this render thread.
+     */
+    bool isCurrentThread() const;
+
+private:
+    /* The loop of the thread */
+    void run();
+
+    GLFWwindow* _window;                    ///< The window whose context is used
+    std::thread _thread;                    ///< The thread
+    std::mutex  _mutex;                     ///< The lock of the queue
+    std::condition_variable _cv_task;       ///< Notified when a task is submitted
+    std::condition_variable _cv_idle;       ///< Notified when the queue is drained
+    std::deque<std::packaged_task<void()>> _tasks;  ///< The queue of tasks
+    bool _is_busy;                          ///< Whether a task is running
+    bool _should_stop;                      ///< Whether the thread should exit
+};
+
+GL_UTIL_END
+#endif // GL_UTIL_RENDER_THREAD_H_LF
@@ -25,18 +25,83 @@
  * vertex and fragment shader files. The valid flag of the Shader Program Object will be 
  * checked before any calling related to Shader Program Object, ensuring safe call of 
  * interfaces.
+ * 2026.10.16 Cache the uniform locations, and take the uniform names as string_view.
+ * 2026.10.16 Add program reflection and typed uniform handles.
+ * 2026.10.16 Add loadAsync() to compile and link on the driver threads.
+ * 2026.10.16 Add watch() to reload the shader files once they are changed.
+ * 2026.10.16 Preprocess the shader files, resolving #include and injecting defines.
+ * 2026.10.16 Add bindUniformBlock() for uniform blocks shared by programs.
+ * 2026.10.16 Load the program from any stages, for gl_util::ComputeShader.
+ * 2026.10.16 Add loadStages() for geometry and tessellation stages, and separable
+ * programs for gl_util::ProgramPipeline.
+ * 2026.10.16 Shadow the uniform values to skip identical uploads, set the uniforms by
+ * glProgramUniform*() so the program needs not be in use, and add array setters.
+ * 2026.10.16 Add loadFromSource() to load the GLSL code in memory, e.g. embedded.
+ * 2026.10.16 Add loadSpirv() to load SPIR-V modules with specialization constants.
+ * 2026.10.16 Let gl_util::ShaderRegistry submit the preprocessed sources directly.
+ * 2026.10.16 Make Shader movable, so it can be stored in containers by value.
+ * 2026.10.16 Keep the stages, defines, files and watches of the current program if a load
+ * fails.
  * -------------------------------------------------------------------------------------*/
 #ifndef GL_UTIL_SHADER_H_LF
 #define GL_UTIL_SHADER_H_LF
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include <atomic>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <fstream>
 #include <sstream>
+#include <vector>
 #include "gl_util_ns.h"
+#include "gl_uniform_cache.h"
+#include "gl_uniform.h"
+#include "gl_shader_preprocessor.h"
 
 GL_UTIL_BEGIN
 
+/**
+ * @brief A stage of a program, i.e. the shader type like GL_VERTEX_SHADER, and the
+ * path of its file.
+ */
+typedef std::pair<GLenum, std::string> ShaderStage;
+
+/**
+ * @brief A stage of a program from the GLSL code in memory, i.e. the shader type and
+ * the code.
+ */
+typedef std::pair<GLenum, std::string_view> ShaderSource;
+
+/**
+ * @brief A specialization constant of the SPIR-V modules, i.e.
+ * 'layout(constant_id = N) const ...' in GLSL, which is also defined as a macro for
+ * the GLSL fallback of gl_util::Shader::loadSpirv().
+ */
+struct SpecializationConstant {
+    /**
+     * @brief Construct a SpecializationConstant object of the GLSL type.
+     *
+     * @param id  The constant_id.
+     * @param name  The name of the macro in the GLSL fallback.
+     * @param value  The value.
+     */
+    SpecializationConstant(GLuint id, const std::string& name, int value);
+    SpecializationConstant(GLuint id, const std::string& name, GLuint value);
+    SpecializationConstant(GLuint id, const std::string& name, float value);
+    SpecializationConstant(GLuint id, const std::string& name, bool value);
+
+    GLuint      id;         ///< The constant_id
+    GLuint      value;      ///< The bits of the value, a bool is 0 or 1
+    std::string name;       ///< The name of the macro in the GLSL fallback
+    std::string literal;    ///< The value as a GLSL literal, e.g. '4u' or '0.5'
+};
+
+/**
+ * @brief The specialization constants of a program.
+ */
+typedef std::vector<SpecializationConstant> SpecializationConstants;
+
 /**
  * @brief A manager for shader program object * 
  */
@@ -65,6 +130,22 @@ public:
      */
     Shader& operator=(const Shader&) = delete;
 
+    /**
+     * @brief Move constructor, the program and the settings are taken from the other
+     * Shader, which is left without program like a new Shader.
+     *
+     * @note The handles from uniform<T>() and gl_util::ProgramPipeline refer to the
+     * Shader object, so they should be obtained and attached again from the new one.
+     * A pending program submitted by gl_util::ShaderBatch should be finished first.
+     */
+    Shader(Shader&& other) noexcept;
+
+    /**
+     * @brief Move assignment, the program of this Shader is deleted first, see the
+     * move constructor.
+     */
+    Shader& operator=(Shader&& other) noexcept;
+
     /**
      * @brief Destroy the Shader object.
      * 
@@ -78,6 +159,8 @@ public:
      * 
      * @param vs_path  The path of vertex shader file
      * @param fs_path  The path of fragment shader file
+     * @param defines  The macros injected after '#version' of both files, see
+     * gl_util::ShaderPreprocessor for the '#include' resolution.
      * @return 
      *   @retval true  Succeed to load the two files.
      *   @retval false Otherwise.
@@ -86,7 +169,243 @@ public:
      * shader files. What should be CAREFULLY NOTICED is, make sure the correct window
      * is made current.
      */
-    bool load(const std::string &vs_path, const std::string &fs_path);
+    bool load(const std::string &vs_path, const std::string &fs_path,
+              const ShaderDefines &defines = ShaderDefines());
+
+    /**
+     * @brief Submit the vertex and fragment shader files to compile and link, and
+     * return without waiting for the driver.
+     *
+     * @details With GL_KHR_parallel_shader_compile or GL_ARB_parallel_shader_compile,
+     * the driver compiles on its own threads, and isReady() polls
+     * GL_COMPLETION_STATUS. The program is linked into a new program object, so the
+     * previous program (if any) is still used until finish().
+     * @code
+     * shader.loadAsync("scene.vs", "scene.fs");
+     * while(!shader.isReady()) {
+     *     // render the loading screen ...
+     * }
+     * shader.finish();
+     * @endcode
+     *
+     * @return
+     *   @retval true  Succeed to read the files and submit them.
+     *   @retval false Otherwise.
+     *
+     * @note use() swaps to the new program once it is ready, or waits for it if there
+     * is no previous program. Uniform handles from uniform<T>() are resolved again
+     * after the swap.
+     */
+    bool loadAsync(const std::string &vs_path, const std::string &fs_path,
+                   const ShaderDefines &defines = ShaderDefines());
+
+    /**
+     * @brief Load the files of any stages into the program, e.g. with geometry or
+     * tessellation stages.
+     * @code
+     * shader.loadStages({ { GL_VERTEX_SHADER,          "terrain.vs" },
+     *                     { GL_TESS_CONTROL_SHADER,    "terrain.tcs" },
+     *                     { GL_TESS_EVALUATION_SHADER, "terrain.tes" },
+     *                     { GL_FRAGMENT_SHADER,        "terrain.fs" } });
+     * glPatchParameteri(GL_PATCH_VERTICES, 4);
+     * // draw with GL_PATCHES ...
+     * @endcode
+     *
+     * @param stages  The stages, each of a different shader type.
+     * @param defines  The macros injected after '#version' of all the files.
+     * @return
+     *   @retval true  Succeed to load the files.
+     *   @retval false Otherwise.
+     */
+    bool loadStages(const std::vector<ShaderStage> &stages,
+                    const ShaderDefines &defines = ShaderDefines());
+
+    /**
+     * @brief Submit the files of any stages without waiting for the driver, see
+     * loadStages() and loadAsync().
+     */
+    bool loadStagesAsync(const std::vector<ShaderStage> &stages,
+                         const ShaderDefines &defines = ShaderDefines());
+
+    /**
+     * @brief Load the vertex and fragment GLSL code in memory, without reading files.
+     *
+     * @details Together with the CMake function gl_util_embed_shaders(), the shaders
+     * are built into the binary, so the program starts without the shader files.
+     * @code
+     * #include "app_shaders.h"    // generated by gl_util_embed_shaders()
+     *
+     * app_shaders::addSources();  // for the '#include' of the embedded files
+     * shader.loadFromSource(app_shaders::scene_vs, app_shaders::scene_fs);
+     * @endcode
+     *
+     * @param vs_code  The code of vertex shader.
+     * @param fs_code  The code of fragment shader.
+     * @param defines  The macros injected after '#version' of both codes.
+     * @return
+     *   @retval true  Succeed to load the two codes.
+     *   @retval false Otherwise.
+     *
+     * @note The '#include' is resolved by gl_util::ShaderPreprocessor::addSource(),
+     * or in the include directories. A program loaded from the code cannot be
+     * watched.
+     */
+    bool loadFromSource(std::string_view vs_code, std::string_view fs_code,
+                        const ShaderDefines &defines = ShaderDefines());
+
+    /**
+     * @brief Load the GLSL code of any stages in memory, see loadFromSource() and
+     * loadStages().
+     */
+    bool loadStagesFromSource(const std::vector<ShaderSource> &sources,
+                              const ShaderDefines &defines = ShaderDefines());
+
+    /**
+     * @brief Submit the GLSL code of any stages without waiting for the driver, see
+     * loadStagesFromSource() and loadAsync().
+     */
+    bool loadStagesFromSourceAsync(const std::vector<ShaderSource> &sources,
+                                   const ShaderDefines &defines = ShaderDefines());
+
+    /**
+     * @brief Load the precompiled SPIR-V modules of the stages, specialized by the
+     * constants, or the GLSL files instead if SPIR-V is not supported.
+     *
+     * @details The SPIR-V modules skip the GLSL compiling of the driver, and the
+     * variants are specialized from the same modules. Each module is a stage with the
+     * entry point 'main', e.g. compiled by 'glslangValidator -G scene.fs -o
+     * scene.fs.spv'. The GLSL fallback defines the constants as macros, so a constant
+     * is written as
+     * @code
+     * #ifdef GL_SPIRV
+     * layout(constant_id = 0) const int NUM_LIGHTS = 4;
+     * #endif
+     * @endcode
+     * and loaded by
+     * @code
+     * gl_util::SpecializationConstants constants = { { 0, "NUM_LIGHTS", 8 } };
+     * shader.loadSpirv({ { GL_VERTEX_SHADER,   "scene.vs.spv" },
+     *                    { GL_FRAGMENT_SHADER, "scene.fs.spv" } }, constants,
+     *                  { { GL_VERTEX_SHADER,   "scene.vs" },
+     *                    { GL_FRAGMENT_SHADER, "scene.fs" } });
+     * @endcode
+     *
+     * @param spirv_stages  The SPIR-V files of the stages.
+     * @param constants  The specialization constants.
+     * @param glsl_stages  The GLSL files of the same stages, loaded if SPIR-V is not
+     * supported.
+     * @return
+     *   @retval true  Succeed to load the modules, or the GLSL files.
+     *   @retval false Otherwise.
+     *
+     * @note A program of SPIR-V modules cannot be linked with GLSL stages, but it can
+     * be combined with GLSL programs by gl_util::ProgramPipeline if separable. The
+     * uniforms without 'layout(location = N)' have no names in SPIR-V, so set them
+     * by location.
+     */
+    bool loadSpirv(const std::vector<ShaderStage> &spirv_stages,
+                   const SpecializationConstants &constants = SpecializationConstants(),
+                   const std::vector<ShaderStage> &glsl_stages = std::vector<ShaderStage>());
+
+    /**
+     * @brief Submit the SPIR-V modules or the GLSL fallback without waiting for the
+     * driver, see loadSpirv() and loadAsync().
+     */
+    bool loadSpirvAsync(const std::vector<ShaderStage> &spirv_stages,
+                        const SpecializationConstants &constants = SpecializationConstants(),
+                        const std::vector<ShaderStage> &glsl_stages =
+                            std::vector<ShaderStage>());
+
+    /**
+     * @brief Check whether SPIR-V modules can be loaded in current context, i.e. GL 4.6
+     * or GL_ARB_gl_spirv.
+     */
+    static bool isSpirvSupported();
+
+    /**
+     * @brief Link the program as separable, so that its stages can be combined with
+     * the stages of other programs by gl_util::ProgramPipeline.
+     *
+     * @note Applied by the next load, and by the reloads.
+     */
+    void setSeparable(bool is_separable = true);
+
+    /**
+     * @brief Check whether the program is linked as separable.
+     */
+    bool isSeparable() const;
+
+    /**
+     * @brief Get the stage bits of the program, like GL_VERTEX_SHADER_BIT, for
+     * glUseProgramStages().
+     *
+     * @note The stages of a pending program are counted once it is linked.
+     */
+    GLbitfield stageBits() const;
+
+    /**
+     * @brief Check, without blocking, whether the pending program of loadAsync() has
+     * been compiled and linked.
+     *
+     * @note Always true if the parallel shader compile extension is not supported, in
+     * which case finish() waits for the driver.
+     */
+    bool isReady() const;
+
+    /**
+     * @brief Check whether a program submitted by loadAsync() is not finished.
+     */
+    bool isPending() const;
+
+    /**
+     * @brief Wait for the pending program, check the errors, and swap to it.
+     *
+     * @return
+     *   @retval true  The program is valid, either the new one or the loaded one.
+     *   @retval false The pending program failed, the previous program is kept.
+     */
+    bool finish();
+
+    /**
+     * @brief Reload the shader files in the background once they are changed.
+     *
+     * @details The files are watched by gl_util::FileWatcher, which only sets a flag
+     * on its thread. The next use() submits the files by loadAsync(), and swaps to the
+     * new program once it is linked. If the files fail to compile or link, the errors
+     * are logged and the previous program keeps rendering. Uniform handles from
+     * uniform<T>() are resolved again after the swap.
+     * @code
+     * shader.load("scene.vs", "scene.fs");
+     * shader.watch();
+     * @endcode
+     *
+     * @param enable  Whether to watch the files of the last load() or loadAsync(),
+     * including the included files. The files of a pending loadAsync() are watched
+     * too, which are replaced by the current ones if it fails to link.
+     * @return
+     *   @retval true  The files are watched, or the watch is removed.
+     *   @retval false No file is loaded, or the files cannot be watched.
+     */
+    bool watch(bool enable = true);
+
+    /**
+     * @brief Check whether the shader files are watched.
+     */
+    bool isWatched() const;
+
+    /**
+     * @brief Get the generation of the program, increased each time a new program is
+     * swapped in by finish().
+     */
+    uint32_t generation() const { return _generation; }
+
+    /**
+     * @brief Reload the changed files, and swap to the pending program if it is ready,
+     * without activating the program. Called by use().
+     *
+     * @return Whether the program is valid.
+     */
+    bool update();
 
     /**
      * @brief Activate current shader program object before rendering.
@@ -99,7 +418,7 @@ public:
      * @param name  The name of 'bool' object in GLSL.
      * @param value  The value to be set.
      */
-    void setBool(const std::string &name, bool value) const;
+    void setBool(std::string_view name, bool value) const;
    
     /**
      * @brief Set the 'int' object to Shader (GLSL).
@@ -107,7 +426,7 @@ public:
      * @param name  The name of 'int' object in GLSL.
      * @param value  The value to be set.
      */
-    void setInt(const std::string &name, int value) const;
+    void setInt(std::string_view name, int value) const;
     
     /**
      * @brief Set the 'float' object to Shader (GLSL).
@@ -115,7 +434,7 @@ public:
      * @param name  The name of 'float' object in GLSL.
      * @param value  The value to be set.
      */
-    void setFloat(const std::string &name, float value) const;
+    void setFloat(std::string_view name, float value) const;
 
     /**
      * @brief Set 3 float objects to Shader (GLSL).
@@ -127,7 +446,7 @@ public:
      * 
      * @sa also gl_util::Shader::setVec3().
      */
-    void setFloat3(const std::string &name, float x, float y, float z) const;
+    void setFloat3(std::string_view name, float x, float y, float z) const;
 
     /**
      * @brief Set 4 float objects to Shader (GLSL).
@@ -140,7 +459,7 @@ public:
      * 
      * @sa also gl_util::Shader::setVec4().
      */
-    void setFloat4(const std::string &name, float x, float y, float z, float w) const;
+    void setFloat4(std::string_view name, float x, float y, float z, float w) const;
 
     /**
      * @brief Set the 'vec3f' object to Shader (GLSL).
@@ -152,7 +471,7 @@ public:
      * 
      * @sa also gl_util::Shader::setFloat3().
      */
-    void setVec3f(const std::string &name, const glm::vec3 &vec) const;
+    void setVec3f(std::string_view name, const glm::vec3 &vec) const;
 
     /**
      * @brief Set 3 float objects to Shader (GLSL).
@@ -166,7 +485,7 @@ public:
      * 
      * @sa also gl_util::Shader::setFloat3().
      */
-    void setVec3f(const std::string &name, float x, float y, float z) const;
+    void setVec3f(std::string_view name, float x, float y, float z) const;
 
     /**
      * @brief Set the 'vec4f' object to Shader (GLSL).
@@ -178,7 +497,7 @@ public:
      * 
      * @sa also gl_util::Shader::setFloat4().
      */
-    void setVec4f(const std::string &name, const glm::vec4 &vec) const;
+    void setVec4f(std::string_view name, const glm::vec4 &vec) const;
 
     /**
      * @brief Set the 4 float objects to Shader (GLSL).
@@ -193,7 +512,7 @@ public:
      * 
      * @sa also gl_util::Shader::setFloat4().
      */
-    void setVec4f(const std::string &name, float x, float y, float z, float w) const;
+    void setVec4f(std::string_view name, float x, float y, float z, float w) const;
 
     /**
      * @brief Set the 'mat4f' object to Shader (GLSL).
@@ -204,9 +523,141 @@ public:
      * @param name  The name of 'mat4f' object in GLSL.
      * @param value  The value to be set.
      */
-    void setMat4f(const std::string &name, const glm::mat4 &mat) const;
+    void setMat4f(std::string_view name, const glm::mat4 &mat) const;
+
+    /**
+     * @brief Set the 'vec4' array to Shader (GLSL) by one upload.
+     *
+     * @param name  The name of the array in GLSL, or 'name[i]' to start from the
+     * element i.
+     * @param vecs  The values to be set.
+     * @param count  The number of values.
+     */
+    void setVec4fArray(std::string_view name, const glm::vec4 *vecs, GLsizei count) const;
+
+    /**
+     * @brief Set the 'mat4' array to Shader (GLSL) by one upload, e.g. the bone
+     * matrices.
+     *
+     * @param name  The name of the array in GLSL, or 'name[i]' to start from the
+     * element i.
+     * @param mats  The values to be set.
+     * @param count  The number of values.
+     */
+    void setMat4fArray(std::string_view name, const glm::mat4 *mats, GLsizei count) const;
+
+    /**
+     * @brief Forget the shadowed uniform values, e.g. after setting them by raw GL
+     * calls. The next value of each uniform is uploaded.
+     *
+     * @details The set*() functions and the handles of uniform<T>() keep a copy of
+     * the values set last time, and skip the upload of a bit-identical value.
+     */
+    void invalidateUniforms();
+
+    /**
+     * @brief Get the number of uniform values uploaded.
+     */
+    uint64_t uniformIssuedCount() const;
+
+    /**
+     * @brief Get the number of uniform uploads skipped, since the values are
+     * identical to the shadow.
+     */
+    uint64_t uniformSkippedCount() const;
+
+    /**
+     * @brief Reset the uploaded and skipped counters.
+     */
+    void resetUniformCounters();
+
+    /**
+     * @brief Resolve a typed handle of the uniform.
+     *
+     * @details The location and the GLSL type are checked once here. If the program
+     * has no active uniform of the name, or its type does not match T, an error is
+     * logged and an invalid handle is returned.
+     *
+     * @tparam T  The C++ type, see gl_util::UniformTraits. 'int' also matches GLSL
+     * samplers and images, and 'bool' also matches GLSL bools set by integers.
+     * @param name  The name of the uniform in GLSL, e.g. "mvp" or "lights[2]".
+     */
+    template <typename T>
+    Uniform<T> uniform(std::string_view name) const {
+        GLint array_size = 0;
+        GLint location = resolveUniform(name, UniformTraits<T>::type, array_size);
+        return Uniform<T>(this, name, _generation, _id, location, array_size);
+    }
+
+    /**
+     * @brief Bind the uniform block to the uniform buffer binding point, see
+     * gl_util::UniformBuffer. The binding is applied again after each reload.
+     *
+     * @param name  The name of the uniform block in GLSL.
+     * @param binding  The binding point.
+     * @return
+     *   @retval true  Succeed.
+     *   @retval false The program has no active uniform block of the name.
+     */
+    bool bindUniformBlock(std::string_view name, GLuint binding);
+
+    /**
+     * @brief Bind the shader storage block to the binding point, see
+     * gl_util::ShaderStorageBuffer. The binding is applied again after each reload.
+     *
+     * @param name  The name of the buffer block in GLSL.
+     * @param binding  The binding point.
+     * @return
+     *   @retval true  Succeed.
+     *   @retval false The program has no active storage block of the name.
+     */
+    bool bindStorageBlock(std::string_view name, GLuint binding);
+
+    /**
+     * @brief Get the GL program object, 0 if not created.
+     */
+    GLuint ID() const;
+
+    /**
+     * @brief Get the active uniforms of the linked program, including the members of
+     * uniform blocks.
+     */
+    const std::vector<ShaderResource>& uniforms() const;
+
+    /**
+     * @brief Get the active vertex attributes of the linked program.
+     */
+    const std::vector<ShaderResource>& attributes() const;
+
+    /**
+     * @brief Get the active uniform blocks of the linked program.
+     */
+    const std::vector<ShaderResource>& uniformBlocks() const;
+
+    /**
+     * @brief Get the active shader storage blocks of the linked program.
+     */
+    const std::vector<ShaderResource>& storageBlocks() const;
+
+    /**
+     * @brief Find the uniform of the name from the reflection, nullptr if not found.
+     *
+     * @param name  The name, for arrays both 'name' and 'name[0]' are accepted.
+     */
+    const ShaderResource* findUniform(std::string_view name) const;
 
 private:
+    template <typename T>
+    friend class Uniform;
+    friend class ShaderRegistry;
+
+    /** The binding point of a block set by bindUniformBlock() or bindStorageBlock() **/
+    struct BlockBinding {
+        GLenum      interface;  ///< GL_UNIFORM_BLOCK or GL_SHADER_STORAGE_BLOCK
+        std::string name;       ///< The name of the block
+        GLuint      binding;    ///< The binding point
+    };
+
     /**
      * @brief  Check whether shader files are successfully read.
      * 
@@ -216,6 +667,54 @@ private:
      */
     bool isShaderValid() const;
 
+    /* Exchange the programs and the settings with the other Shader */
+    void swap(Shader& other) noexcept;
+
+    /* Get the location of the uniform from the cache */
+    GLint uniformLocation(std::string_view name) const;
+
+    /* Compare the values with the shadow, return true if they should be uploaded */
+    bool isUniformChanged(GLint location, const void* data, GLsizei count,
+                          size_t size) const;
+
+    /** Where the codes of a load come from **/
+    enum CodeOrigin {
+        FROM_FILES,     ///< The GLSL files
+        FROM_SOURCES,   ///< The GLSL code in memory
+        FROM_SPIRV      ///< The SPIR-V files
+    };
+
+    /* Compile and link the preprocessed codes, or specialize the SPIR-V modules, of the
+       stages into a pending program. The load is recorded once the program is linked */
+    bool submit(const std::vector<ShaderStage> &stages, const ShaderDefines &defines,
+                const std::vector<std::string> &codes, std::vector<std::string> &files,
+                CodeOrigin origin,
+                const SpecializationConstants &constants = SpecializationConstants());
+
+    /* Get the location of the uniform if its type matches, -1 otherwise */
+    GLint resolveUniform(std::string_view name, GLenum type, GLint& array_size) const;
+
+    /* Query the active resources after linking */
+    void reflect();
+
+    /* Record the stages, defines and files of the pending load as the current ones */
+    void recordPending();
+
+    /* Delete the pending program and its shaders */
+    void discardPending();
+
+    /* Watch the files, replacing the flag of the watches */
+    bool watchFiles(const std::vector<std::string> &files);
+
+    /* Remove the watches of the files */
+    void unwatch();
+
+    /* Record the binding of the block, and apply it if the program is created */
+    bool bindBlock(GLenum interface, std::string_view name, GLuint binding);
+
+    /* Apply the block bindings to the program, return false if any block is missing */
+    bool applyBlockBindings() const;
+
     /**
      * @brief The Shader Program Object.
      * To use the vertex shader and fragment shader, the two shaders should be linked to
@@ -225,7 +724,87 @@ private:
     unsigned int _id;
 
     bool _has_created; ///< Whether the shader program object is created successfully.
+
+    bool     _is_separable;         ///< Whether the program is linked as separable
+    bool     _is_pending;           ///< Whether a program is being compiled and linked
+    GLuint   _pending_id;           ///< The program being compiled and linked
+    std::vector<GLuint> _pending_shaders;   ///< The shaders being compiled
+    uint64_t _pending_key;          ///< The key of the pending program binary
+    CodeOrigin _pending_origin;     ///< Where the codes of the pending program come from
+    std::vector<ShaderStage> _pending_stages;   ///< The stages of the pending program
+    SpecializationConstants _pending_constants; ///< The constants of the pending program
+    ShaderDefines _pending_defines; ///< The defines of the pending program
+    std::vector<std::string> _pending_files;///< The files read for the pending program
+    uint32_t _generation;           ///< The number of programs swapped in
+
+    std::vector<ShaderStage> _stages;   ///< The stages of the current program
+    CodeOrigin _origin;             ///< Where the codes of the program come from
+    SpecializationConstants _constants; ///< The specialization constants of the program
+    ShaderDefines _defines;         ///< The defines of the current program
+    std::vector<std::string> _files;///< The files read for the program, with includes
+    std::vector<uint64_t> _watches; ///< The watches of the files
+    /** Set by the watcher thread once a file is changed, shared so that a late
+        callback never writes to a destroyed Shader. **/
+    std::shared_ptr<std::atomic<bool>> _is_changed;
+
+    mutable UniformLocationCache _uniform_locations; ///< The cached uniform locations
+    mutable UniformValueCache _uniform_values;       ///< The shadowed uniform values
+
+    std::vector<ShaderResource> _uniforms;          ///< The active uniforms
+    std::vector<ShaderResource> _attributes;        ///< The active attributes
+    std::vector<ShaderResource> _uniform_blocks;    ///< The active uniform blocks
+    std::vector<ShaderResource> _storage_blocks;    ///< The active storage blocks
+
+    std::vector<BlockBinding> _block_bindings;      ///< The bindings of the blocks
 };
 
+template <typename T>
+bool Uniform<T>::resolve() const {
+    // Resolve again once the shader swapped to a new program.
+    if(_shader && _shader->generation() != _generation) {
+        Uniform<T> handle = _shader->uniform<T>(_name);
+        _generation = handle._generation;
+        _program = handle._program;
+        _location = handle._location;
+        _array_size = handle._array_size;
+    }
+    return _location >= 0;
+}
+
+template <typename T>
+void Uniform<T>::set(const T& value) const {
+    set(&value, 1);
+}
+
+template <typename T>
+void Uniform<T>::set(const T* values, GLsizei count) const {
+    if(!resolve()) return;
+    count = std::min<GLsizei>(count, _array_size);
+    // Skipped if identical to the values set last time through the shader.
+    if(_shader && !_shader->isUniformChanged(_location, values, count, sizeof(T))) {
+        return;
+    }
+    UniformTraits<T>::set(_program, _location, count, values);
+}
+
+template <>
+inline void Uniform<bool>::set(const bool* values, GLsizei count) const {
+    if(!resolve()) return;
+    count = std::min<GLsizei>(count, _array_size);
+    // Converted to integers in chunks, and shadowed as the integers as setBool() does,
+    // so both keep one size of the values.
+    GLint buffer[16];
+    for(GLsizei i = 0; i < count; i += 16) {
+        GLsizei n = std::min<GLsizei>(16, count - i);
+        for(GLsizei j = 0; j < n; j++) {
+            buffer[j] = values[i + j] ? 1 : 0;
+        }
+        if(_shader && !_shader->isUniformChanged(_location + i, buffer, n, sizeof(GLint))) {
+            continue;
+        }
+        UniformTraits<int>::set(_program, _location + i, n, buffer);
+    }
+}
+
 GL_UTIL_END
 #endif // GL_UTIL_SHADER_H_LF
\ No newline at end of file
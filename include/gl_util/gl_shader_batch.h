@@ -0,0 +1,100 @@
+/** -------------------------------------------------------------------------------------
+ *
+ *   				                 OpenGL Utilities
+ *
+ * @file 		gl_shader_batch.h
+ *
+ * @brief 		Load many shader programs at once without blocking the render loop.
+ *
+ * @author		Longfei Wang
+ *
+ * @version		1.0.0
+ *
+ * @date		2026/10/16
+ *
+ * @license		MIT
+ *
+ * Copyright (C) 2021-Now Longfei Wang.
+ * ------------------------------------------------------------------------------------*/
+#ifndef GL_UTIL_SHADER_BATCH_H_LF
+#define GL_UTIL_SHADER_BATCH_H_LF
+#include <string>
+#include <vector>
+#include "gl_util_ns.h"
+
+GL_UTIL_BEGIN
+
+class Shader;
+
+/**
+ * @brief A batch of shaders loaded by gl_util::Shader::loadAsync(), so that the
+ * driver compiles all of them in parallel.
+ *
+ * @code
+ * gl_util::ShaderBatch batch;
+ * for(auto& item : materials) {
+ *     batch.add(item.shader, item.vs_path, item.fs_path);
+ * }
+ * while(batch.poll() > 0) {
+ *     // render the loading screen, e.g. with progress batch.finishedCount()
+ * }
+ * @endcode
+ *
+ * @note The shaders should outlive the batch, and all the calls should be made with
+ * the same context current.
+ */
+class ShaderBatch {
+public:
+    /**
+     * @brief Construct an empty ShaderBatch object.
+     */
+    ShaderBatch();
+
+    /**
+     * @brief Submit the shader files, see gl_util::Shader::loadAsync().
+     *
+     * @return
+     *   @retval true  Succeed to submit.
+     *   @retval false Failed to read the files, the shader is counted as failed.
+     */
+    bool add(Shader& shader, const std::string& vs_path, const std::string& fs_path);
+
+    /**
+     * @brief Finish the shaders that are ready, without blocking.
+     *
+     * @return The number of shaders still pending.
+     */
+    size_t poll();
+
+    /**
+     * @brief Wait for and finish all the pending shaders.
+     *
+     * @return
+     *   @retval true  All the shaders of the batch are loaded.
+     *   @retval false Otherwise.
+     */
+    bool finish();
+
+    /**
+     * @brief Get the number of shaders added to the batch.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Get the number of finished shaders, including the failed ones.
+     */
+    size_t finishedCount() const;
+
+    /**
+     * @brief Get the number of failed shaders.
+     */
+    size_t failedCount() const;
+
+private:
+    std::vector<Shader*> _pending;  ///< The shaders not finished yet
+    size_t _size;                   ///< The number of added shaders
+    size_t _failed_count;           ///< The number of failed shaders
+};
+
+GL_UTIL_END
+#endif // GL_UTIL_SHADER_BATCH_H_LF
@@ -0,0 +1,122 @@
+/** -------------------------------------------------------------------------------------
+ *
+ *   				                 OpenGL Utilities
+ *
+ * @file 		gl_shader_preprocessor.h
+ *
+ * @brief 		Resolve #include and inject #define in GLSL sources.
+ *
+ * @author		Longfei Wang
+ *
+ * @version		1.0.0
+ *
+ * @date		2026/10/16
+ *
+ * @license		MIT
+ *
+ * Copyright (C) 2021-Now Longfei Wang.
+ * ------------------------------------------------------------------------------------*/
+#ifndef GL_UTIL_SHADER_PREPROCESSOR_H_LF
+#define GL_UTIL_SHADER_PREPROCESSOR_H_LF
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "gl_util_ns.h"
+
+GL_UTIL_BEGIN
+
+/**
+ * @brief A set of macros injected into GLSL sources, as pairs of name and value.
+ * The value may be empty.
+ * @code
+ * gl_util::ShaderDefines defines = { { "USE_SHADOW", "" }, { "NUM_LIGHTS", "4" } };
+ * @endcode
+ */
+typedef std::vector<std::pair<std::string, std::string>> ShaderDefines;
+
+/**
+ * @brief The preprocessor stage of gl_util::Shader::load(), run before the sources
+ * are passed to the driver.
+ *
+ * @details
+ * + '#include "file"' is searched relative to the including file first, then in the
+ * sources added by addSource(), and then in the include directories.
+ * '#include <file>' is searched in the sources and the include directories only.
+ * Each file is included once per stage, so include guards are not required.
+ * + The defines are inserted right after the '#version' line.
+ * + '#line' directives are inserted around includes, with the source string number
+ * being the index of the file in the returned file list. So '3(12)' in a compile
+ * error means line 12 of the fourth file.
+ *
+ * @note The directives are recognized line by line, so an '#include' inside a block
+ * comment is still resolved.
+ */
+class ShaderPreprocessor {
+public:
+    /**
+     * @brief Add a directory to search the included files in.
+     */
+    static void addIncludeDirectory(const std::string& directory);
+
+    /**
+     * @brief Remove all the include directories.
+     */
+    static void clearIncludeDirectories();
+
+    /**
+     * @brief Add a source in memory to be included by its name, e.g. a file embedded
+     * by the CMake function gl_util_embed_shaders(), so that no file is read.
+     *
+     * @param name  The name in '#include', replacing the source of the same name.
+     * @param code  The code, which is not copied and should outlive the preprocessing,
+     * e.g. a string literal.
+     */
+    static void addSource(const std::string& name, std::string_view code);
+
+    /**
+     * @brief Check whether a source in memory is added by the name.
+     */
+    static bool hasSource(const std::string& name);
+
+    /**
+     * @brief Remove all the sources in memory.
+     */
+    static void clearSources();
+
+    /**
+     * @brief Read the file, resolve the includes and inject the defines.
+     *
+     * @param path  The path of the GLSL file.
+     * @param defines  The macros to define.
+     * @param source  Output the preprocessed source.
+     * @param files  The files read so far, the file and its includes are appended if
+     * not in the list. Pass the same list for all the stages of a program, so that
+     * each file has a unique source string number.
+     * @return
+     *   @retval true  Succeed to read the file and all its includes.
+     *   @retval false Otherwise, the files read are still appended to the list.
+     */
+    static bool process(const std::string& path, const ShaderDefines& defines,
+                        std::string& source, std::vector<std::string>& files);
+
+    /**
+     * @brief Preprocess the code in memory as process() does, with no file read
+     * unless the includes are not added by addSource().
+     *
+     * @param code  The GLSL code.
+     * @param name  The name of the code in the file list, shown in the errors.
+     */
+    static bool processSource(std::string_view code, const std::string& name,
+                              const ShaderDefines& defines, std::string& source,
+                              std::vector<std::string>& files);
+
+    /**
+     * @brief Get a key of the define set, independent of the order of the defines.
+     * A define repeated later overrides the earlier one.
+     */
+    static std::string key(const ShaderDefines& defines);
+};
+
+GL_UTIL_END
+#endif // GL_UTIL_SHADER_PREPROCESSOR_H_LF
@@ -0,0 +1,143 @@
+/** -------------------------------------------------------------------------------------
+ *
+ *   				                 OpenGL Utilities
+ *
+ * @file 		gl_shader_registry.h
+ *
+ * @brief 		Share one linked program among all the users of the same sources.
+ *
+ * @author		Longfei Wang
+ *
+ * @version		1.0.0
+ *
+ * @date		2026/10/16
+ *
+ * @license		MIT
+ *
+ * Copyright (C) 2021-Now Longfei Wang.
+ * ------------------------------------------------------------------------------------*/
+#ifndef GL_UTIL_SHADER_REGISTRY_H_LF
+#define GL_UTIL_SHADER_REGISTRY_H_LF
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "gl_util_ns.h"
+#include "gl_shader.h"
+
+GL_UTIL_BEGIN
+
+/**
+ * @brief A registry of the linked programs, keyed on the hash of the preprocessed
+ * sources, which include the defines, and verified against the sources on a hit. The
+ * same sources are linked once, and the program is shared by reference-counted
+ * handles.
+ *
+ * @details The registry only holds weak references, so the program is deleted once
+ * the last handle is released. Loading the same sources again after that links a
+ * new program, or loads it from gl_util::ProgramBinaryCache if enabled.
+ * @code
+ * // Hundreds of objects of the same material share one program.
+ * for(Object& object : objects) {
+ *     object.shader = gl_util::ShaderRegistry::shared().load("mat.vs", "mat.fs");
+ * }
+ * @endcode
+ *
+ * @note The programs are shared by all the windows, since their contexts share
+ * objects. The handles should be released with a context current, as gl_util::Shader.
+ * @note A shared program should not be loaded again through a handle, which changes
+ * it for all the users. watch() is fine, the reloaded program is still shared.
+ */
+class ShaderRegistry {
+public:
+    /**
+     * @brief Get the registry shared by the library.
+     */
+    static ShaderRegistry& shared();
+
+    /**
+     * @brief Delete copy constructor.
+     */
+    ShaderRegistry(const ShaderRegistry&) = delete;
+
+    /**
+     * @brief Delete assignment constructor.
+     */
+    ShaderRegistry& operator=(const ShaderRegistry&) = delete;
+
+    /**
+     * @brief Get the program of the vertex and fragment shader files, linked if no
+     * program of the same sources is alive.
+     *
+     * @param vs_path  The path of vertex shader file
+     * @param fs_path  The path of fragment shader file
+     * @param defines  The macros injected after '#version' of both files.
+     * @return The shared program, nullptr if failed to load.
+     *
+     * @note The files are read and preprocessed for the key each time, which is much
+     * cheaper than linking.
+     */
+    std::shared_ptr<Shader> load(const std::string &vs_path, const std::string &fs_path,
+                                 const ShaderDefines &defines = ShaderDefines());
+
+    /**
+     * @brief Get the program of the files of any stages, see load() and
+     * gl_util::Shader::loadStages().
+     */
+    std::shared_ptr<Shader> loadStages(const std::vector<ShaderStage> &stages,
+                                       const ShaderDefines &defines = ShaderDefines());
+
+    /**
+     * @brief Get the program of the vertex and fragment GLSL code in memory, see
+     * gl_util::Shader::loadFromSource().
+     *
+     * @note Keyed on the code as given, so the code should be the same, rather than
+     * include the same files.
+     */
+    std::shared_ptr<Shader> loadFromSource(std::string_view vs_code,
+                                           std::string_view fs_code,
+                                           const ShaderDefines &defines = ShaderDefines());
+
+    /**
+     * @brief Get the number of the programs alive.
+     */
+    size_t size();
+
+    /**
+     * @brief Get the number of the loads that shared a program alive.
+     */
+    uint64_t sharedCount() const;
+
+    /**
+     * @brief Get the number of the loads that linked a new program.
+     */
+    uint64_t linkedCount() const;
+
+private:
+    /* Create an empty registry, see shared() */
+    ShaderRegistry();
+
+    /** A program, with the sources to verify the hash **/
+    struct Entry {
+        std::string sources;            ///< The stages and codes joined
+        std::weak_ptr<Shader> shader;   ///< The program
+    };
+
+    /* Get the program alive of the key and the same sources, nullptr if not */
+    std::shared_ptr<Shader> find(uint64_t key, const std::string& sources);
+
+    /* Record the program of the key, and remove the released ones */
+    void insert(uint64_t key, std::string sources, const std::shared_ptr<Shader>& shader);
+
+    std::mutex _mutex;                                  ///< Guards the map
+    std::unordered_map<uint64_t, Entry> _shaders;       ///< The programs by the hash
+    std::atomic<uint64_t> _shared;  ///< The number of loads that shared a program
+    std::atomic<uint64_t> _linked;  ///< The number of loads that linked a program
+};
+
+GL_UTIL_END
+#endif // GL_UTIL_SHADER_REGISTRY_H_LF
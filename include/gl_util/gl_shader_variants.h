@@ -0,0 +1,115 @@
+/** -------------------------------------------------------------------------------------
+ *
+ *   				                 OpenGL Utilities
+ *
+ * @file 		gl_shader_variants.h
+ *
+ * @brief 		A cache of shader permutations compiled on first request.
+ *
+ * @author		Longfei Wang
+ *
+ * @version		1.0.0
+ *
+ * @date		2026/10/16
+ *
+ * @license		MIT
+ *
+ * Copyright (C) 2021-Now Longfei Wang.
+ * ------------------------------------------------------------------------------------*/
+#ifndef GL_UTIL_SHADER_VARIANTS_H_LF
+#define GL_UTIL_SHADER_VARIANTS_H_LF
+#include <map>
+#include <memory>
+#include <string>
+#include "gl_util_ns.h"
+#include "gl_shader.h"
+
+GL_UTIL_BEGIN
+
+/**
+ * @brief The permutations of a pair of vertex and fragment shader files, which differ
+ * by the defines only.
+ *
+ * @details A variant is compiled by gl_util::Shader::loadAsync() the first time its
+ * define set is requested, and the same Shader is returned for the define set later,
+ * in any order of the defines. So only the variants really used are compiled and
+ * linked, and the variants requested before their first use() are compiled in
+ * parallel if the driver supports it.
+ * @code
+ * gl_util::ShaderVariants variants("mesh.vs", "mesh.fs");
+ * while(...) {
+ *     gl_util::Shader& shader = variants.get({ { "USE_SHADOW", "" } });
+ *     shader.use();
+ * }
+ * @endcode
+ *
+ * @note The variants are deleted with the ShaderVariants object, so the same context
+ * should be current then.
+ */
+class ShaderVariants {
+public:
+    /**
+     * @brief Construct a new ShaderVariants object, nothing is compiled until get().
+     *
+     * @param vs_path  The path of vertex shader file
+     * @param fs_path  The path of fragment shader file
+     * @param defines  The defines shared by all the variants.
+     */
+    ShaderVariants(const std::string &vs_path, const std::string &fs_path,
+                   const ShaderDefines &defines = ShaderDefines());
+
+    /**
+     * @brief Delete copy constructor.
+     */
+    ShaderVariants(const ShaderVariants&) = delete;
+
+    /**
+     * @brief Delete assignment constructor.
+     */
+    ShaderVariants& operator=(const ShaderVariants&) = delete;
+
+    /**
+     * @brief Get the variant of the defines, compiled if not requested before.
+     *
+     * @param defines  The defines added to the shared ones, overriding the shared
+     * define of the same name.
+     * @return The variant, which stays valid until clear(). If the files failed to
+     * read or compile, the returned Shader is not valid and is not compiled again,
+     * unless the files are watched.
+     */
+    Shader& get(const ShaderDefines &defines = ShaderDefines());
+
+    /**
+     * @brief Check whether the variant of the defines has been requested.
+     */
+    bool contains(const ShaderDefines &defines) const;
+
+    /**
+     * @brief Get the number of variants requested.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Delete all the variants.
+     */
+    void clear();
+
+    /**
+     * @brief Reload the variants once the files are changed, see
+     * gl_util::Shader::watch(). The variants requested later are watched as well.
+     */
+    void watch(bool enable = true);
+
+private:
+    /* Merge the shared defines and the defines of the variant */
+    ShaderDefines merge(const ShaderDefines &defines) const;
+
+    std::string   _vs_path;     ///< The vertex shader file
+    std::string   _fs_path;     ///< The fragment shader file
+    ShaderDefines _defines;     ///< The defines shared by all the variants
+    bool          _is_watched;  ///< Whether the variants are watched
+    std::map<std::string, std::unique_ptr<Shader>> _variants; ///< The variants by key
+};
+
+GL_UTIL_END
+#endif // GL_UTIL_SHADER_VARIANTS_H_LF
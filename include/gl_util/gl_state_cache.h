@@ -0,0 +1,269 @@
+/** -------------------------------------------------------------------------------------
+ *
+ *   				                 OpenGL Utilities
+ *
+ * @file 		gl_state_cache.h
+ *
+ * @brief 		A per-context shadow of GL state to filter out redundant state changes.
+ *
+ * @author		Longfei Wang
+ *
+ * @version		1.0.0
+ *
+ * @date		2026/10/16
+ *
+ * @license		MIT
+ *
+ * Copyright (C) 2021-Now Longfei Wang.
+ * ------------------------------------------------------------------------------------*/
+#ifndef GL_UTIL_STATE_CACHE_H_LF
+#define GL_UTIL_STATE_CACHE_H_LF
+#include <glad/glad.h>
+#include <atomic>
+#include <cstdint>
+#include "gl_util_ns.h"
+
+GL_UTIL_BEGIN
+
+/**
+ * @brief A shadow copy of the bindings and fixed-function state of one context.
+ *
+ * @details All the classes of gl_util change the program, vertex array, buffer,
+ * texture, capability, depth, blend and clear color state through the cache of
+ * current context, so a call that sets the value already set is skipped.
+ *
+ * @code
+ * gl_util::StateCache& cache = gl_util::StateCache::current();
+ * cache.useProgram(program);
+ * cache.bindTextureUnit(0, GL_TEXTURE_2D, texture);
+ * printf("skipped %llu of %llu calls\n", cache.skippedCount(),
+ *        cache.skippedCount() + cache.issuedCount());
+ * @endcode
+ *
+ * @note The cache does not know about GL calls made directly. Call invalidate() after
+ * changing the state listed above by raw GL calls or another library, then the next
+ * call of each state is issued again.
+ * @note Each cache is only accessed by the thread where its context is current.
+ */
+class StateCache {
+public:
+    /**
+     * @brief Get the cache of current context, which is created on first use.
+     */
+    static StateCache& current();
+
+    /**
+     * @brief Invalidate the cache of a context, e.g. when the context is destroyed.
+     *
+     * @details Any thread can call it. The cache is only marked here, and invalidated
+     * by the next current() on the thread of the context.
+     *
+     * @param context  The GLFWwindow of the context, or nullptr for all the contexts.
+     */
+    static void invalidateContext(const void* context);
+
+    /**
+     * @brief Delete copy constructor.
+     */
+    StateCache(const StateCache&) = delete;
+
+    /**
+     * @brief Delete assignment constructor.
+     */
+    StateCache& operator=(const StateCache&) = delete;
+
+    /**
+     * @brief Forget all the shadowed state, the next call of each state is issued.
+     */
+    void invalidate();
+
+    /**
+     * @brief glUseProgram().
+     */
+    void useProgram(GLuint program);
+
+    /**
+     * @brief glBindProgramPipeline().
+     *
+     * @note The pipeline is only used when no program is in use, see useProgram(0).
+     */
+    void bindProgramPipeline(GLuint pipeline);
+
+    /**
+     * @brief glBindVertexArray().
+     *
+     * @note The GL_ELEMENT_ARRAY_BUFFER binding becomes unknown, since it is a state
+     * of the vertex array.
+     */
+    void bindVertexArray(GLuint vao);
+
+    /**
+     * @brief glBindBuffer(). Targets without shadow are always issued.
+     */
+    void bindBuffer(GLenum target, GLuint buffer);
+
+    /**
+     * @brief glBindBufferRange(). Only GL_UNIFORM_BUFFER and GL_SHADER_STORAGE_BUFFER
+     * below MAX_INDEXED_BINDINGS are shadowed, others are always issued.
+     *
+     * @note The generic binding of the target is changed to the buffer as well.
+     */
+    void bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset,
+                         GLsizeiptr size);
+
+    /**
+     * @brief glBindBufferBase(), see bindBufferRange().
+     */
+    void bindBufferBase(GLenum target, GLuint index, GLuint buffer);
+
+    /**
+     * @brief glActiveTexture().
+     *
+     * @param unit  The texture unit index, i.e. 0 for GL_TEXTURE0.
+     */
+    void activeTexture(GLuint unit);
+
+    /**
+     * @brief glBindTexture() on the active texture unit. Targets without shadow are
+     * always issued.
+     */
+    void bindTexture(GLenum target, GLuint texture);
+
+    /**
+     * @brief Bind a texture to a texture unit, i.e. activeTexture() + bindTexture().
+     *
+     * @note The active texture unit is not switched if the texture is already bound
+     * to the unit.
+     */
+    void bindTextureUnit(GLuint unit, GLenum target, GLuint texture);
+
+    /**
+     * @brief glEnable() or glDisable(). Capabilities without shadow are always issued.
+     */
+    void setCapability(GLenum cap, bool enable);
+
+    /**
+     * @brief glEnable().
+     */
+    void enable(GLenum cap);
+
+    /**
+     * @brief glDisable().
+     */
+    void disable(GLenum cap);
+
+    /**
+     * @brief glDepthFunc().
+     */
+    void depthFunc(GLenum func);
+
+    /**
+     * @brief glDepthMask().
+     */
+    void depthMask(GLboolean flag);
+
+    /**
+     * @brief glBlendFunc().
+     */
+    void blendFunc(GLenum src, GLenum dst);
+
+    /**
+     * @brief glBlendEquation().
+     */
+    void blendEquation(GLenum mode);
+
+    /**
+     * @brief glClearColor().
+     */
+    void clearColor(float R, float G, float B, float A);
+
+    /**
+     * @brief glDeleteProgram(), and forget the program in all the caches.
+     */
+    void deleteProgram(GLuint program);
+
+    /**
+     * @brief glDeleteProgramPipelines(), and forget the pipelines in all the caches.
+     */
+    void deleteProgramPipelines(GLsizei n, const GLuint* pipelines);
+
+    /**
+     * @brief glDeleteVertexArrays(), and forget the vertex arrays in all the caches.
+     */
+    void deleteVertexArrays(GLsizei n, const GLuint* vaos);
+
+    /**
+     * @brief glDeleteBuffers(), and forget the buffers in all the caches.
+     */
+    void deleteBuffers(GLsizei n, const GLuint* buffers);
+
+    /**
+     * @brief glDeleteTextures(), and forget the textures in all the caches.
+     */
+    void deleteTextures(GLsizei n, const GLuint* textures);
+
+    /**
+     * @brief Get the number of GL calls issued through the cache.
+     */
+    uint64_t issuedCount() const;
+
+    /**
+     * @brief Get the number of redundant GL calls skipped by the cache.
+     */
+    uint64_t skippedCount() const;
+
+    /**
+     * @brief Reset the issued and skipped counters.
+     */
+    void resetCounters();
+
+    static constexpr uint8_t MAX_TEXTURE_UNITS = 32;    ///< The shadowed texture units
+    static constexpr uint8_t NUM_BUFFER_TARGETS = 10;   ///< The shadowed buffer targets
+    static constexpr uint8_t NUM_TEXTURE_TARGETS = 4;   ///< The shadowed texture targets
+    static constexpr uint8_t NUM_CAPABILITIES = 10;     ///< The shadowed capabilities
+    static constexpr uint8_t MAX_INDEXED_BINDINGS = 16; ///< The shadowed indexed bindings
+    static constexpr uint8_t NUM_INDEXED_TARGETS = 2;   ///< The shadowed indexed targets
+
+private:
+    /** A buffer range bound to an indexed binding point **/
+    struct IndexedBinding {
+        GLuint     buffer;
+        GLintptr   offset;
+        GLsizeiptr size;    ///< -1 for the whole buffer by glBindBufferBase()
+    };
+
+    /* Create an invalidated cache, see current() */
+    StateCache();
+
+    /* Update the cache after deleting objects in current context */
+    void onDelete();
+
+    /* Check the value against its shadow, and update the shadow if it differs */
+    template <typename T>
+    bool update(T& shadow, T value);
+
+    GLuint   _program;                                  ///< The program in use
+    GLuint   _pipeline;                                 ///< The bound program pipeline
+    GLuint   _vao;                                      ///< The bound vertex array
+    GLuint   _buffers[NUM_BUFFER_TARGETS];              ///< The bound buffers
+    IndexedBinding _indexed[NUM_INDEXED_TARGETS][MAX_INDEXED_BINDINGS]; ///< The ranges
+    GLuint   _active_unit;                              ///< The active texture unit
+    GLuint   _textures[MAX_TEXTURE_UNITS][NUM_TEXTURE_TARGETS]; ///< The bound textures
+    int8_t   _capabilities[NUM_CAPABILITIES];           ///< 1 on, 0 off, -1 unknown
+    GLenum   _depth_func;                               ///< The depth function
+    GLint    _depth_mask;                               ///< The depth mask
+    GLenum   _blend_src;                                ///< The source blend factor
+    GLenum   _blend_dst;                                ///< The destination factor
+    GLenum   _blend_equation;                           ///< The blend equation
+    float    _clear_color[4];                           ///< The clear color
+    bool     _has_clear_color;                          ///< Whether clear color is known
+
+    uint64_t _delete_epoch;     ///< The deletions of all caches seen by this cache
+    /** Set by invalidateContext(), so that the cache is invalidated on its thread **/
+    std::atomic<bool> _is_invalidated;
+    uint64_t _issued;           ///< The number of issued calls
+    uint64_t _skipped;          ///< The number of skipped calls
+};
+
+GL_UTIL_END
+#endif // GL_UTIL_STATE_CACHE_H_LF
@@ -0,0 +1,214 @@
+/** -------------------------------------------------------------------------------------
+ *
+ *   				                 OpenGL Utilities
+ *
+ * @file 		gl_stereo.h
+ *
+ * @brief 		Single-pass stereo rendering for binocular (near-eye) displays.
+ *
+ * @author		Longfei Wang
+ *
+ * @version		1.0.0
+ *
+ * @date		2026/10/16
+ *
+ * @license		MIT
+ *
+ * Copyright (C) 2021-Now Longfei Wang.
+ * ------------------------------------------------------------------------------------*/
+#ifndef GL_UTIL_STEREO_H_LF
+#define GL_UTIL_STEREO_H_LF
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <string>
+#include "gl_util_ns.h"
+#include "gl_projection.h"
+
+GL_UTIL_BEGIN
+
+class Shader;
+
+/**
+ * @brief A pair of projections and eye transforms for the left and right eyes.
+ */
+class StereoProjection {
+public:
+    /**
+     * @brief Construct a new StereoProjection object.
+     *
+     * @param left  The projection of the left eye.
+     * @param right  The projection of the right eye.
+     * @param baseline  The distance between the two eyes. The eyes are placed at
+     * -baseline/2 and +baseline/2 along the x-axis of the view (head) frame.
+     */
+    StereoProjection(const Projection& left, const Projection& right, float baseline);
+
+    /**
+     * @brief Construct a new StereoProjection object with the same projection for
+     * both eyes.
+     */
+    StereoProjection(const Projection& projection, float baseline);
+
+    /**
+     * @brief Set the transforms from the view (head) frame to each eye frame, for the
+     * eyes that are not placed symmetrically.
+     */
+    void setEyeTransforms(const glm::mat4& left, const glm::mat4& right);
+
+    /**
+     * @brief Get the projection of an eye.
+     *
+     * @param eye  0 for the left eye, 1 for the right eye.
+     */
+    const Projection& projection(uint8_t eye) const;
+
+    /**
+     * @brief Get the view-projection matrix of an eye, i.e. P_eye * T_eye * view.
+     *
+     * @param eye  0 for the left eye, 1 for the right eye.
+     * @param view  The view matrix of the head.
+     */
+    glm::mat4 viewProjection(uint8_t eye, const glm::mat4& view) const;
+
+    /**
+     * @brief Adapt both projections to the Near-Eye Display.
+     *
+     * @see gl_util::Projection::adaptToNED().
+     */
+    StereoProjection adaptToNED(float ocular_fov, uint16_t screen_w, uint16_t screen_h,
+                                uint16_t disp_w = 0, uint16_t disp_h = 0) const;
+
+private:
+    Projection _projections[2];     ///< The projections of left and right eyes
+    glm::mat4  _eye_transforms[2];  ///< The transforms from view frame to eye frames
+};
+
+/**
+ * @brief The technique to route the two eyes within one draw call.
+ */
+enum StereoMode {
+    STEREO_LAYERED,         ///< Write gl_Layer in vertex shader, one layer per eye.
+    STEREO_VIEWPORT_ARRAY,  ///< Write gl_ViewportIndex in vertex shader, side by side.
+    STEREO_INSTANCED        ///< Shift and clip the eyes to the two halves of one
+                            ///< viewport, side by side. Works on any GL 3.3+ context.
+};
+
+/**
+ * @brief Render the left and right views in one submission.
+ *
+ * @details Each draw is issued once with twice the instances, and the vertex shader
+ * selects the eye by gl_InstanceID & 1. Depending on the support of
+ * ARB_shader_viewport_layer_array (or AMD_vertex_shader_layer/viewport_index), the
+ * eye is routed to a layer of a 2-layer texture array, to one of two viewports, or by
+ * instancing with clip distances as the fallback.
+ *
+ * The vertex shader should contain the code of vertexShaderHeader() right after the
+ * '#version' line, and compute the position by stereoPosition():
+ * @code
+ * #version 450 core
+ * // ... code of StereoRenderer::vertexShaderHeader() ...
+ * layout (location = 0) in vec3 a_pos;
+ * void main() {
+ *     gl_Position = stereoPosition(model * vec4(a_pos, 1.0));
+ * }
+ * @endcode
+ * If the shader uses instancing itself, its instance index is gl_InstanceID >> 1.
+ */
+class StereoRenderer {
+public:
+    /**
+     * @brief Construct a new StereoRenderer object.
+     *
+     * @param eye_width  The width of each eye.
+     * @param eye_height  The height of each eye.
+     * @param mode  The preferred mode, which falls back to STEREO_INSTANCED if not
+     * supported by current context.
+     */
+    StereoRenderer(uint16_t eye_width, uint16_t eye_height,
+                   StereoMode mode = STEREO_LAYERED);
+
+    /**
+     * @brief Delete copy constructor.
+     */
+    StereoRenderer(const StereoRenderer&) = delete;
+
+    /**
+     * @brief Delete assignment constructor.
+     */
+    StereoRenderer& operator=(const StereoRenderer&) = delete;
+
+    /**
+     * @brief Destroy the StereoRenderer object.
+     */
+    ~StereoRenderer();
+
+    /**
+     * @brief Get the mode in use.
+     */
+    StereoMode mode() const;
+
+    /**
+     * @brief Get the GLSL code to insert after the '#version' line of vertex shader,
+     * which declares 'uniform mat4 stereo_vp[2]' and 'vec4 stereoPosition(vec4)'.
+     */
+    std::string vertexShaderHeader() const;
+
+    /**
+     * @brief Bind the stereo target, clear it, and upload the view-projection matrices
+     * of both eyes to 'stereo_vp' of the shader.
+     *
+     * @note The shader will be used.
+     */
+    void begin(Shader& shader, const StereoProjection& projection,
+               const glm::mat4& view);
+
+    /**
+     * @brief Draw both eyes by glDrawArraysInstanced.
+     */
+    void drawArrays(GLenum mode, GLint first, GLsizei count);
+
+    /**
+     * @brief Draw both eyes by glDrawElementsInstanced.
+     */
+    void drawElements(GLenum mode, GLsizei count, GLenum type,
+                      const void* indices = nullptr);
+
+    /**
+     * @brief Finish the stereo pass and restore the state changed by begin().
+     */
+    void end();
+
+    /**
+     * @brief Blit an eye to another framebuffer, e.g. the window of that eye.
+     *
+     * @param eye  0 for the left eye, 1 for the right eye.
+     * @param dst_fbo  The destination framebuffer.
+     * @param dst_width  The width of destination region.
+     * @param dst_height  The height of destination region.
+     */
+    void blitEye(uint8_t eye, GLuint dst_fbo, uint16_t dst_width, uint16_t dst_height);
+
+    /**
+     * @brief Get the color texture, a GL_TEXTURE_2D_ARRAY of 2 layers for
+     * STEREO_LAYERED, or a side-by-side GL_TEXTURE_2D otherwise.
+     */
+    GLuint colorTexture() const;
+
+private:
+    /* Create the render target for current mode */
+    void createTarget();
+
+    uint16_t   _eye_width;      ///< The width of each eye
+    uint16_t   _eye_height;     ///< The height of each eye
+    StereoMode _mode;           ///< The mode in use
+    bool       _is_amd_ext;     ///< Whether the AMD extensions are used instead of ARB
+
+    GLuint _fbo;                ///< The stereo framebuffer
+    GLuint _eye_fbos[2];        ///< The per-layer framebuffers to blit, layered only
+    GLuint _color;              ///< The color texture
+    GLuint _depth;              ///< The depth texture
+    GLint  _viewport[4];        ///< The viewport before begin()
+};
+
+GL_UTIL_END
+#endif // GL_UTIL_STEREO_H_LF
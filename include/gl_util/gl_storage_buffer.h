@@ -0,0 +1,214 @@
+/** -------------------------------------------------------------------------------------
+ *
+ *   				                 OpenGL Utilities
+ *
+ * @file 		gl_storage_buffer.h
+ *
+ * @brief 		Typed shader storage buffer objects.
+ *
+ * @author		Longfei Wang
+ *
+ * @version		1.0.0
+ *
+ * @date		2026/10/16
+ *
+ * @license		MIT
+ *
+ * Copyright (C) 2021-Now Longfei Wang.
+ * ------------------------------------------------------------------------------------*/
+#ifndef GL_UTIL_STORAGE_BUFFER_H_LF
+#define GL_UTIL_STORAGE_BUFFER_H_LF
+#include <glad/glad.h>
+#include <cstddef>
+#include <type_traits>
+#include "gl_util_ns.h"
+
+GL_UTIL_BEGIN
+
+/**
+ * @brief The untyped buffer of gl_util::ShaderStorageBuffer, with the sizes and
+ * offsets in bytes.
+ */
+class StorageBuffer {
+public:
+    /** The default flags of the storage, allowing upload, download and mapping **/
+    static constexpr GLbitfield DEFAULT_FLAGS = GL_DYNAMIC_STORAGE_BIT | GL_MAP_READ_BIT |
+                                                GL_MAP_WRITE_BIT;
+
+    /**
+     * @brief Construct a new StorageBuffer object with immutable storage.
+     *
+     * @param size  The size in bytes.
+     * @param data  The initial data, nullptr for undefined content.
+     * @param flags  The flags of glBufferStorage().
+     */
+    StorageBuffer(size_t size, const void* data = nullptr,
+                  GLbitfield flags = DEFAULT_FLAGS);
+
+    /**
+     * @brief Delete copy constructor.
+     */
+    StorageBuffer(const StorageBuffer&) = delete;
+
+    /**
+     * @brief Delete assignment constructor.
+     */
+    StorageBuffer& operator=(const StorageBuffer&) = delete;
+
+    /**
+     * @brief Move constructor, the buffer is taken from the other StorageBuffer, which
+     * is left without buffer and of zero size.
+     */
+    StorageBuffer(StorageBuffer&& other) noexcept;
+
+    /**
+     * @brief Move assignment, the buffer of this StorageBuffer is deleted first.
+     */
+    StorageBuffer& operator=(StorageBuffer&& other) noexcept;
+
+    /**
+     * @brief Destroy the StorageBuffer object, the buffer is unmapped and deleted.
+     */
+    ~StorageBuffer();
+
+    /**
+     * @brief Write the data into the range by glBufferSubData().
+     *
+     * @note Requires GL_DYNAMIC_STORAGE_BIT.
+     */
+    bool uploadBytes(const void* data, size_t offset, size_t size);
+
+    /**
+     * @brief Read the range into the data by glGetBufferSubData(), which waits for
+     * GPU. Call gl_util::ComputeShader::memoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT)
+     * after the dispatches writing it.
+     */
+    bool downloadBytes(void* data, size_t offset, size_t size) const;
+
+    /**
+     * @brief Fill the buffer with zeros.
+     */
+    void clear();
+
+    /**
+     * @brief Map the range, nullptr if failed.
+     *
+     * @param offset  The offset in bytes.
+     * @param size  The size in bytes.
+     * @param access  The access of glMapBufferRange(), e.g. GL_MAP_READ_BIT or
+     * GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT.
+     */
+    void* mapBytes(size_t offset, size_t size, GLbitfield access);
+
+    /**
+     * @brief Unmap the buffer.
+     */
+    void unmap();
+
+    /**
+     * @brief Bind the whole buffer to the shader storage binding point.
+     */
+    void bind(GLuint binding) const;
+
+    /**
+     * @brief Bind the range to the shader storage binding point. The offset should
+     * be a multiple of GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT.
+     */
+    void bindBytes(GLuint binding, size_t offset, size_t size) const;
+
+    /**
+     * @brief Get the size in bytes.
+     */
+    size_t bytes() const;
+
+    /**
+     * @brief Get the buffer object, e.g. for gl_util::ComputeShader::dispatchIndirect().
+     */
+    GLuint ID() const;
+
+private:
+    /* Check whether the range is inside the buffer */
+    bool isInRange(size_t offset, size_t size) const;
+
+    /* Exchange the buffers with the other StorageBuffer */
+    void swap(StorageBuffer& other) noexcept;
+
+    GLuint _buffer;     ///< The buffer
+    size_t _size;       ///< The size in bytes
+    bool   _is_mapped;  ///< Whether the buffer is mapped
+};
+
+/**
+ * @brief A shader storage buffer of an array of T, accessed by compute and other
+ * shaders as 'layout(std430, binding = N) buffer Name { T data[]; };'.
+ *
+ * @code
+ * gl_util::ShaderStorageBuffer<glm::vec4> spheres(count, bounds.data());
+ * gl_util::ShaderStorageBuffer<GLuint> visible(count);
+ * spheres.bind(0);
+ * visible.bind(1);
+ * cull.dispatchThreads(count);
+ * gl_util::ComputeShader::memoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+ * @endcode
+ *
+ * @tparam T  A trivially copyable type whose layout matches std430, e.g. glm::vec3
+ * has a 16-byte stride in std430 arrays, so use glm::vec4 instead.
+ */
+template <typename T>
+class ShaderStorageBuffer : public StorageBuffer {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "ShaderStorageBuffer<T> requires a trivially copyable T");
+public:
+    /**
+     * @brief Construct a new ShaderStorageBuffer object.
+     *
+     * @param count  The number of elements.
+     * @param data  The initial elements, nullptr for undefined content.
+     * @param flags  The flags of glBufferStorage().
+     */
+    explicit ShaderStorageBuffer(size_t count, const T* data = nullptr,
+                                 GLbitfield flags = DEFAULT_FLAGS)
+        : StorageBuffer(count * sizeof(T), data, flags) {
+    }
+
+    /**
+     * @brief Get the number of elements.
+     */
+    size_t size() const {
+        return bytes() / sizeof(T);
+    }
+
+    /**
+     * @brief Write the elements from the first one.
+     */
+    bool upload(const T* data, size_t count, size_t first = 0) {
+        return uploadBytes(data, first * sizeof(T), count * sizeof(T));
+    }
+
+    /**
+     * @brief Read the elements from the first one, see downloadBytes().
+     */
+    bool download(T* data, size_t count, size_t first = 0) const {
+        return downloadBytes(data, first * sizeof(T), count * sizeof(T));
+    }
+
+    /**
+     * @brief Map the elements from the first one, see mapBytes().
+     */
+    T* map(GLbitfield access, size_t first = 0, size_t count = size_t(-1)) {
+        if(first > size()) return nullptr;
+        count = count < size() - first ? count : size() - first;
+        return (T*)mapBytes(first * sizeof(T), count * sizeof(T), access);
+    }
+
+    /**
+     * @brief Bind the elements from the first one to the binding point, see
+     * bindBytes().
+     */
+    void bindRange(GLuint binding, size_t first, size_t count) const {
+        bindBytes(binding, first * sizeof(T), count * sizeof(T));
+    }
+};
+
+GL_UTIL_END
+#endif // GL_UTIL_STORAGE_BUFFER_H_LF
@@ -20,6 +20,8 @@
  * Change History:                        
  * 
  * 2022.4.29 Refactor the codes.
+ * 2026.10.16 Delete the texture in the destructor, and make Texture2D movable and
+ * non-copyable.
  * * ------------------------------------------------------------------------------------
  * References:
  * https://learnopengl-cn.github.io/01%20Getting%20started/06%20Textures/
@@ -46,6 +48,34 @@ public:
      */
     Texture2D(unsigned char texture_id = 0);
 
+    /**
+     * @brief Delete copy constructor.
+     *
+     * @note Texture2D owns the GL texture, a copy would delete it twice.
+     */
+    Texture2D(const Texture2D&) = delete;
+
+    /**
+     * @brief Delete assignment constructor.
+     */
+    Texture2D& operator=(const Texture2D&) = delete;
+
+    /**
+     * @brief Move constructor, the texture and the texture unit are taken from the
+     * other Texture2D, which is left without texture.
+     */
+    Texture2D(Texture2D&& other) noexcept;
+
+    /**
+     * @brief Move assignment, the texture of this Texture2D is deleted first.
+     */
+    Texture2D& operator=(Texture2D&& other) noexcept;
+
+    /**
+     * @brief Destroy the Texture2D object, the texture is deleted.
+     */
+    ~Texture2D();
+
     /**
      * @brief Load an image as the texture
      * 
@@ -87,6 +117,9 @@ public:
     void release();
 
 private:
+    /* Exchange the textures with the other Texture2D */
+    void swap(Texture2D& other) noexcept;
+
     unsigned char   _texture_id;  ///< The index of current texture
     GLuint          _texture;     ///< The texture object created by GL
     bool            _has_texture; ///< The flag whether texture has been load
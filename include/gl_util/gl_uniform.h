@@ -0,0 +1,213 @@
+/** -------------------------------------------------------------------------------------
+ *
+ *   				                 OpenGL Utilities
+ *
+ * @file 		gl_uniform.h
+ *
+ * @brief 		Program resources from reflection, and typed uniform handles.
+ *
+ * @author		Longfei Wang
+ *
+ * @version		1.0.0
+ *
+ * @date		2026/10/16
+ *
+ * @license		MIT
+ *
+ * Copyright (C) 2021-Now Longfei Wang.
+ * ------------------------------------------------------------------------------------*/
+#ifndef GL_UTIL_UNIFORM_H_LF
+#define GL_UTIL_UNIFORM_H_LF
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "gl_util_ns.h"
+
+GL_UTIL_BEGIN
+
+class Shader;
+
+/**
+ * @brief An active resource of a linked program, i.e. a uniform, an attribute, a
+ * uniform block or a shader storage block.
+ */
+struct ShaderResource {
+    std::string name;       ///< The name, arrays are named like 'name[0]'
+    GLenum type;            ///< The GL type like GL_FLOAT_MAT4, 0 for blocks
+    GLint  location;        ///< The location, -1 for blocks and block members
+    GLint  array_size;      ///< The number of array elements, 1 for non-array
+    GLint  block_index;     ///< The block of a uniform, -1 in the default block
+    GLint  binding;         ///< The binding point of a block, -1 otherwise
+    GLint  data_size;       ///< The minimum buffer size in bytes of a block
+};
+
+/**
+ * @brief The GL type and glProgramUniform* call of the C++ type of a uniform.
+ *
+ * @details Specialized for bool, int, unsigned int, float, and glm vec2-4, ivec2-4,
+ * uvec2-4, mat2-4 types.
+ */
+template <typename T>
+struct UniformTraits;
+
+#define GL_UTIL_UNIFORM_TRAITS(T, GL_TYPE, CALL)                                        \
+template <>                                                                             \
+struct UniformTraits<T> {                                                               \
+    static constexpr GLenum type = GL_TYPE;                                             \
+    static void set(GLuint program, GLint location, GLsizei count, const T* values) {   \
+        CALL;                                                                           \
+    }                                                                                   \
+};
+
+GL_UTIL_UNIFORM_TRAITS(int,         GL_INT,
+    glProgramUniform1iv(program, location, count, values))
+GL_UTIL_UNIFORM_TRAITS(glm::ivec2,  GL_INT_VEC2,
+    glProgramUniform2iv(program, location, count, glm::value_ptr(*values)))
+GL_UTIL_UNIFORM_TRAITS(glm::ivec3,  GL_INT_VEC3,
+    glProgramUniform3iv(program, location, count, glm::value_ptr(*values)))
+GL_UTIL_UNIFORM_TRAITS(glm::ivec4,  GL_INT_VEC4,
+    glProgramUniform4iv(program, location, count, glm::value_ptr(*values)))
+GL_UTIL_UNIFORM_TRAITS(unsigned int, GL_UNSIGNED_INT,
+    glProgramUniform1uiv(program, location, count, values))
+GL_UTIL_UNIFORM_TRAITS(glm::uvec2,  GL_UNSIGNED_INT_VEC2,
+    glProgramUniform2uiv(program, location, count, glm::value_ptr(*values)))
+GL_UTIL_UNIFORM_TRAITS(glm::uvec3,  GL_UNSIGNED_INT_VEC3,
+    glProgramUniform3uiv(program, location, count, glm::value_ptr(*values)))
+GL_UTIL_UNIFORM_TRAITS(glm::uvec4,  GL_UNSIGNED_INT_VEC4,
+    glProgramUniform4uiv(program, location, count, glm::value_ptr(*values)))
+GL_UTIL_UNIFORM_TRAITS(float,       GL_FLOAT,
+    glProgramUniform1fv(program, location, count, values))
+GL_UTIL_UNIFORM_TRAITS(glm::vec2,   GL_FLOAT_VEC2,
+    glProgramUniform2fv(program, location, count, glm::value_ptr(*values)))
+GL_UTIL_UNIFORM_TRAITS(glm::vec3,   GL_FLOAT_VEC3,
+    glProgramUniform3fv(program, location, count, glm::value_ptr(*values)))
+GL_UTIL_UNIFORM_TRAITS(glm::vec4,   GL_FLOAT_VEC4,
+    glProgramUniform4fv(program, location, count, glm::value_ptr(*values)))
+GL_UTIL_UNIFORM_TRAITS(glm::mat2,   GL_FLOAT_MAT2,
+    glProgramUniformMatrix2fv(program, location, count, GL_FALSE, glm::value_ptr(*values)))
+GL_UTIL_UNIFORM_TRAITS(glm::mat3,   GL_FLOAT_MAT3,
+    glProgramUniformMatrix3fv(program, location, count, GL_FALSE, glm::value_ptr(*values)))
+GL_UTIL_UNIFORM_TRAITS(glm::mat4,   GL_FLOAT_MAT4,
+    glProgramUniformMatrix4fv(program, location, count, GL_FALSE, glm::value_ptr(*values)))
+
+#undef GL_UTIL_UNIFORM_TRAITS
+
+template <>
+struct UniformTraits<bool> {
+    // GLSL bools are set as integers, see gl_util::Uniform<bool>::set().
+    static constexpr GLenum type = GL_BOOL;
+};
+
+/**
+ * @brief A uniform handle resolved once by gl_util::Shader::uniform<T>(), then set
+ * without any name lookup.
+ *
+ * @code
+ * gl_util::Uniform<glm::mat4> mvp = shader.uniform<glm::mat4>("mvp");
+ * while(...) {
+ *     mvp.set(projection * view * model);
+ * }
+ * @endcode
+ *
+ * @note The value is set by glProgramUniform*(), so the program needs not be in use.
+ * A value identical to the one set last time through the shader is not uploaded.
+ * @note The handle is resolved again once the shader swaps to a new program, e.g.
+ * after a reload by gl_util::Shader::watch(), so it must not outlive the shader.
+ */
+template <typename T>
+class Uniform {
+public:
+    /**
+     * @brief Construct an invalid Uniform object, whose set() does nothing.
+     */
+    Uniform()
+        : _shader(nullptr)
+        , _generation(0)
+        , _program(0)
+        , _location(-1)
+        , _array_size(0) {
+    }
+
+    /**
+     * @brief Construct a new Uniform object.
+     *
+     * @param program  The program.
+     * @param location  The location of the uniform, -1 for an invalid handle.
+     * @param array_size  The number of elements from the location.
+     */
+    Uniform(GLuint program, GLint location, GLint array_size)
+        : _shader(nullptr)
+        , _generation(0)
+        , _program(program)
+        , _location(location)
+        , _array_size(array_size) {
+    }
+
+    /**
+     * @brief Construct a new Uniform object of the shader, which is resolved again
+     * once the generation of the shader changes.
+     *
+     * @param shader  The shader.
+     * @param name  The name of the uniform in GLSL.
+     * @param generation  The generation of the shader the location is resolved from.
+     * @param program  The program.
+     * @param location  The location of the uniform, -1 for an invalid handle.
+     * @param array_size  The number of elements from the location.
+     */
+    Uniform(const Shader* shader, std::string_view name, uint32_t generation,
+            GLuint program, GLint location, GLint array_size)
+        : _shader(shader)
+        , _name(name)
+        , _generation(generation)
+        , _program(program)
+        , _location(location)
+        , _array_size(array_size) {
+    }
+
+    /**
+     * @brief Check whether the handle refers to an active uniform of matched type.
+     */
+    bool isValid() const {
+        return resolve();
+    }
+
+    /**
+     * @brief Get the location of the uniform.
+     */
+    GLint location() const {
+        resolve();
+        return _location;
+    }
+
+    /**
+     * @brief Set the value of the uniform. Defined in gl_shader.h.
+     */
+    void set(const T& value) const;
+
+    /**
+     * @brief Set the elements of an array uniform. Defined in gl_shader.h.
+     *
+     * @param values  The values.
+     * @param count  The number of values, clamped to the array size.
+     */
+    void set(const T* values, GLsizei count) const;
+
+private:
+    /* Resolve again if the shader changed, and check whether the handle is valid.
+       Defined in gl_shader.h. */
+    bool resolve() const;
+
+    const Shader*    _shader;       ///< The shader, nullptr if never resolved again
+    std::string      _name;         ///< The name of the uniform
+    mutable uint32_t _generation;   ///< The generation of the shader resolved from
+    mutable GLuint   _program;      ///< The program
+    mutable GLint    _location;     ///< The location of the uniform
+    mutable GLint    _array_size;   ///< The number of elements from the location
+};
+
+GL_UTIL_END
+#endif // GL_UTIL_UNIFORM_H_LF
@@ -0,0 +1,251 @@
+/** -------------------------------------------------------------------------------------
+ *
+ *   				                 OpenGL Utilities
+ *
+ * @file 		gl_uniform_buffer.h
+ *
+ * @brief 		Uniform buffer objects of std140 structs, streamed by a persistently
+ *              mapped ring.
+ *
+ * @author		Longfei Wang
+ *
+ * @version		1.0.0
+ *
+ * @date		2026/10/16
+ *
+ * @license		MIT
+ *
+ * Copyright (C) 2021-Now Longfei Wang.
+ * ------------------------------------------------------------------------------------*/
+#ifndef GL_UTIL_UNIFORM_BUFFER_H_LF
+#define GL_UTIL_UNIFORM_BUFFER_H_LF
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "gl_util_ns.h"
+
+GL_UTIL_BEGIN
+
+class Shader;
+
+/**
+ * @brief The std140 base alignment of a C++ type whose size matches its GLSL type.
+ *
+ * @details Specialized for int, unsigned int, float, glm vec2-4, ivec2-4, uvec2-4 and
+ * mat4, and arrays of 16-byte elements. bool and glm::mat2/mat3 are not provided on
+ * purpose, since their C++ sizes differ from std140. Use int, glm::mat4, or arrays of
+ * glm::vec4 instead.
+ */
+template <typename T>
+struct Std140Traits;
+
+#define GL_UTIL_STD140_TRAITS(T, ALIGNMENT)                                             \
+template <>                                                                             \
+struct Std140Traits<T> {                                                                \
+    static constexpr size_t alignment = ALIGNMENT;                                      \
+};
+
+GL_UTIL_STD140_TRAITS(int,          4)
+GL_UTIL_STD140_TRAITS(unsigned int, 4)
+GL_UTIL_STD140_TRAITS(float,        4)
+GL_UTIL_STD140_TRAITS(glm::vec2,    8)
+GL_UTIL_STD140_TRAITS(glm::ivec2,   8)
+GL_UTIL_STD140_TRAITS(glm::uvec2,   8)
+GL_UTIL_STD140_TRAITS(glm::vec3,    16)
+GL_UTIL_STD140_TRAITS(glm::ivec3,   16)
+GL_UTIL_STD140_TRAITS(glm::uvec3,   16)
+GL_UTIL_STD140_TRAITS(glm::vec4,    16)
+GL_UTIL_STD140_TRAITS(glm::ivec4,   16)
+GL_UTIL_STD140_TRAITS(glm::uvec4,   16)
+GL_UTIL_STD140_TRAITS(glm::mat4,    16)
+
+#undef GL_UTIL_STD140_TRAITS
+
+template <typename T, size_t N>
+struct Std140Traits<T[N]> {
+    static_assert(sizeof(T) % 16 == 0,
+                  "std140 arrays have a 16-byte stride, use arrays of glm::vec4 or "
+                  "16-byte structs");
+    static constexpr size_t alignment = 16;
+};
+
+/**
+ * @brief Check at compile time that the member of the struct is placed as std140.
+ * @code
+ * struct Camera {
+ *     glm::mat4 view;
+ *     glm::mat4 projection;
+ *     glm::vec3 position;
+ *     float     time;
+ * };
+ * GL_UTIL_STD140_MEMBER(Camera, view);
+ * GL_UTIL_STD140_MEMBER(Camera, projection);
+ * GL_UTIL_STD140_MEMBER(Camera, position);
+ * GL_UTIL_STD140_MEMBER(Camera, time);
+ * @endcode
+ * A glm::vec3 followed by another glm::vec3, or an array of float, fails to compile.
+ * Nested structs are checked by their own members, and should be padded to 16 bytes.
+ */
+#define GL_UTIL_STD140_MEMBER(Struct, member)                                           \
+    static_assert(offsetof(Struct, member) %                                            \
+                  gl_util::Std140Traits<decltype(Struct::member)>::alignment == 0,       \
+                  #Struct "::" #member " is not aligned as std140")
+
+/**
+ * @brief The untyped ring of gl_util::UniformBuffer.
+ *
+ * @details A buffer of 'frames' segments, each holding 'capacity' elements, is
+ * created by glBufferStorage() and mapped once with GL_MAP_PERSISTENT_BIT and
+ * GL_MAP_COHERENT_BIT. push() writes by memcpy into the segment of current frame and
+ * binds the element by glBindBufferRange(). beginFrame() fences the segment of the
+ * previous frame, and waits for the fence of the next segment only if the GPU is
+ * still more than 'frames' frames behind.
+ */
+class UniformRingBuffer {
+public:
+    /**
+     * @brief Construct a new UniformRingBuffer object.
+     *
+     * @param binding  The uniform buffer binding point.
+     * @param element_size  The size of an element in bytes.
+     * @param capacity  The maximum number of push() in a frame.
+     * @param frames  The number of frames in flight.
+     */
+    UniformRingBuffer(GLuint binding, size_t element_size, size_t capacity = 1,
+                      uint8_t frames = 3);
+
+    /**
+     * @brief Delete copy constructor.
+     */
+    UniformRingBuffer(const UniformRingBuffer&) = delete;
+
+    /**
+     * @brief Delete assignment constructor.
+     */
+    UniformRingBuffer& operator=(const UniformRingBuffer&) = delete;
+
+    /**
+     * @brief Destroy the UniformRingBuffer object, the buffer and fences are deleted.
+     */
+    ~UniformRingBuffer();
+
+    /**
+     * @brief Start a new frame, call once per frame before the first push().
+     *
+     * @return
+     *   @retval true  The segment of the frame was free.
+     *   @retval false The GPU was still reading it, and the call had to wait.
+     */
+    bool beginFrame();
+
+    /**
+     * @brief Write the element into current frame, and bind it to the binding point.
+     *
+     * @return
+     *   @retval true  Succeed.
+     *   @retval false The capacity of the frame is exhausted, nothing is written.
+     */
+    bool push(const void* data);
+
+    /**
+     * @brief Bind the element pushed last time to the binding point again, e.g. after
+     * the binding point is used by another buffer.
+     */
+    void bind() const;
+
+    /**
+     * @brief Get the binding point.
+     */
+    GLuint binding() const;
+
+    /**
+     * @brief Get the number of push() in current frame.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Get the maximum number of push() in a frame.
+     */
+    size_t capacity() const;
+
+    /**
+     * @brief Check whether the block of the shader can be backed by the elements, and
+     * bind the block to the binding point.
+     *
+     * @note Blocks declared with 'layout(std140, binding = N)' need no binding, but
+     * are checked the same way.
+     */
+    bool attach(Shader& shader, std::string_view block) const;
+
+private:
+    GLuint   _binding;      ///< The binding point
+    size_t   _element_size; ///< The size of an element in bytes
+    size_t   _stride;       ///< The element size aligned to the offset alignment
+    size_t   _capacity;     ///< The elements in a frame
+    GLuint   _buffer;       ///< The buffer
+    uint8_t* _data;         ///< The persistently mapped memory
+
+    std::vector<GLsync> _fences;    ///< The fences of the segments
+    size_t   _frame;        ///< The segment of current frame
+    size_t   _count;        ///< The number of push() in current frame
+    GLintptr _last_offset;  ///< The offset of the element pushed last time, -1 if none
+};
+
+/**
+ * @brief A uniform buffer of std140 struct T, shared by all the programs whose block
+ * is bound to the same binding point. It replaces the per-program glUniform*() calls
+ * with one memcpy per update.
+ *
+ * @details For a block shared by the frame, such as the camera, push() once per frame,
+ * the binding stays for all the draws. For per-draw blocks, push() before each draw,
+ * which binds a new range of the ring.
+ * @code
+ * // layout(std140, binding = 0) uniform Camera { mat4 view; mat4 projection; ... };
+ * gl_util::UniformBuffer<Camera> camera(0);
+ * gl_util::UniformBuffer<Model> model(1, 1024);
+ * while(...) {
+ *     camera.beginFrame();
+ *     model.beginFrame();
+ *     camera.push(current_camera);
+ *     for(auto& object : objects) {
+ *         model.push(object.model);
+ *         object.draw();
+ *     }
+ * }
+ * @endcode
+ *
+ * @tparam T  A trivially copyable struct of size multiple of 16, whose members
+ * should be checked by GL_UTIL_STD140_MEMBER.
+ */
+template <typename T>
+class UniformBuffer : public UniformRingBuffer {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "UniformBuffer<T> requires a trivially copyable T");
+    static_assert(sizeof(T) % 16 == 0,
+                  "UniformBuffer<T> requires T padded to a multiple of 16 bytes as std140");
+public:
+    /**
+     * @brief Construct a new UniformBuffer object.
+     *
+     * @param binding  The uniform buffer binding point.
+     * @param capacity  The maximum number of push() in a frame.
+     * @param frames  The number of frames in flight.
+     */
+    explicit UniformBuffer(GLuint binding, size_t capacity = 1, uint8_t frames = 3)
+        : UniformRingBuffer(binding, sizeof(T), capacity, frames) {
+    }
+
+    /**
+     * @brief Write the value into current frame, and bind it to the binding point.
+     */
+    bool push(const T& value) {
+        return UniformRingBuffer::push(&value);
+    }
+};
+
+GL_UTIL_END
+#endif // GL_UTIL_UNIFORM_BUFFER_H_LF
@@ -0,0 +1,145 @@
+/** -------------------------------------------------------------------------------------
+ *
+ *   				                 OpenGL Utilities
+ *
+ * @file 		gl_uniform_cache.h
+ *
+ * @brief 		Caches of the uniform locations and values of a program.
+ *
+ * @author		Longfei Wang
+ *
+ * @version		1.0.0
+ *
+ * @date		2026/10/16
+ *
+ * @license		MIT
+ *
+ * Copyright (C) 2021-Now Longfei Wang.
+ * ------------------------------------------------------------------------------------*/
+#ifndef GL_UTIL_UNIFORM_CACHE_H_LF
+#define GL_UTIL_UNIFORM_CACHE_H_LF
+#include <glad/glad.h>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "gl_util_ns.h"
+
+GL_UTIL_BEGIN
+
+/**
+ * @brief An open-addressing hash table from uniform names to locations.
+ *
+ * @details The location of a name is queried by glGetUniformLocation() only the first
+ * time, including the names that do not exist (location -1). The table uses linear
+ * probing in a power-of-two array, which is kept at most half full.
+ *
+ * @note The cache should be cleared once the program is linked again.
+ */
+class UniformLocationCache {
+public:
+    /**
+     * @brief Construct an empty UniformLocationCache object.
+     */
+    UniformLocationCache();
+
+    /**
+     * @brief Get the location of the uniform in the program.
+     *
+     * @param program  The linked program.
+     * @param name  The name of the uniform, which needs not to be null-terminated.
+     * @return The location, -1 if the program has no active uniform of the name.
+     */
+    GLint location(GLuint program, std::string_view name);
+
+    /**
+     * @brief Remove all the cached locations.
+     */
+    void clear();
+
+    /**
+     * @brief Get the number of cached names.
+     */
+    size_t size() const;
+
+private:
+    struct Entry {
+        uint64_t    hash = 0;           ///< The hash of the name
+        GLint       location = -1;      ///< The uniform location
+        bool        is_used = false;    ///< Whether this entry holds a name
+        std::string name;               ///< The uniform name
+    };
+
+    /* Double the capacity and re-insert all the entries */
+    void grow();
+
+    std::vector<Entry> _entries;    ///< The table, with power-of-two size
+    size_t _count;                  ///< The number of used entries
+};
+
+/**
+ * @brief A CPU-side shadow of the uniform values of a program, by location.
+ *
+ * @details Each location keeps the bytes set last time. A value that is bit-identical
+ * to its shadow needs no upload. An array set from a location covers the following
+ * locations, one per element, so setting a single element later is still tracked.
+ *
+ * @note The cache should be cleared once the program is linked again, and after the
+ * uniforms are set bypassing the cache.
+ */
+class UniformValueCache {
+public:
+    /**
+     * @brief Construct an empty UniformValueCache object.
+     */
+    UniformValueCache();
+
+    /**
+     * @brief Compare the values with the shadow, and update the shadow.
+     *
+     * @param location  The location of the first element, ignored if negative.
+     * @param data  The values of the elements.
+     * @param count  The number of elements.
+     * @param size  The size of an element in bytes.
+     * @return
+     *   @retval true  Any element differs, the values should be uploaded.
+     *   @retval false All the elements are identical, or the location is negative.
+     */
+    bool update(GLint location, const void* data, GLsizei count, size_t size);
+
+    /**
+     * @brief Forget all the values, so that the next value of each location is
+     * uploaded.
+     */
+    void clear();
+
+    /**
+     * @brief Get the number of updates that should be uploaded.
+     */
+    uint64_t issuedCount() const;
+
+    /**
+     * @brief Get the number of updates skipped, since the values are identical.
+     */
+    uint64_t skippedCount() const;
+
+    /**
+     * @brief Reset the issued and skipped counters.
+     */
+    void resetCounters();
+
+private:
+    struct Slot {
+        uint32_t offset = 0;    ///< The offset of the value in the data
+        uint32_t size = 0;      ///< The size of the value, 0 if unknown
+        uint32_t capacity = 0;  ///< The bytes reserved in the data for the value
+    };
+
+    std::vector<Slot>    _slots;    ///< The values by location
+    std::vector<uint8_t> _data;     ///< The bytes of the values
+    uint64_t _issued;               ///< The number of updates to upload
+    uint64_t _skipped;              ///< The number of updates skipped
+};
+
+GL_UTIL_END
+#endif // GL_UTIL_UNIFORM_CACHE_H_LF
@@ -19,11 +19,14 @@
  * --------------------------------------------------------------------------------------
  * Change History:                        
  * 
+ * 2026.10.16 Add hasExtension() to query the extensions of current context.
+ * 2026.10.16 Add headless (EGL/OSMesa) context backend selectable in init().
  * 2022.4.28 Add log to facilate debug.
  * ------------------------------------------------------------------------------------*/
 #ifndef GL_UTIL_NS_H_LF
 #define GL_UTIL_NS_H_LF
 #include <cstdio>
+#include <cstdint>
 
 #define GL_UTIL_BEGIN namespace gl_util{
 #define GL_UTIL_END }
@@ -36,18 +39,67 @@
 
 struct GLFWwindow;
 GL_UTIL_BEGIN
+
+/**
+ * @brief The backend used to create the shared OpenGL context.
+ */
+enum ContextBackend {
+    BACKEND_GLFW,       ///< A hidden 1x1 GLFW window, requires a X/Wayland server.
+    BACKEND_EGL,        ///< EGL surfaceless context (or 1x1 pbuffer), no display needed.
+    BACKEND_OSMESA,     ///< Mesa off-screen software rendering.
+    BACKEND_HEADLESS    ///< Try BACKEND_EGL first, then fall back to BACKEND_OSMESA.
+};
+
 /**
  * @brief Initialization of gl_util.
  * 
  * @param ver_major The major version of OpenGL context that created by GLFW..
  * @param ver_minor The minor version of OpenGL context that created by GLFW..
+ * @param backend The backend to create the shared context. With a headless backend,
+ * Shader, Texture2D and VAVBEBO work without any X/Wayland server, while
+ * gl_util::Window is unavailable.
  * 
  * @return bool
  *   @retval 2 The gl_util is just be initialized successfully. 
  *   @retval 1 The gl_util has been initialized.
  *   @retval 0 Failed to init gl_util, the app will auto-exit. 
  */
-uint8_t init(uint8_t ver_major = 4, uint8_t ver_minor = 5);
+uint8_t init(uint8_t ver_major = 4, uint8_t ver_minor = 5, 
+             ContextBackend backend = BACKEND_GLFW);
+
+/**
+ * @brief Get the backend that actually created the shared context.
+ * 
+ * @note For BACKEND_HEADLESS, the returned value is BACKEND_EGL or BACKEND_OSMESA.
+ */
+ContextBackend backend();
+
+/**
+ * @brief Make the shared context current on the calling thread.
+ * 
+ * @remark For a headless backend this is the only context, so this function is the
+ * counterpart of gl_util::Window::activate().
+ * 
+ * @return 
+ *   @retval true  If the shared context is made current.
+ *   @retval false Otherwise.
+ */
+bool makeSharedContextCurrent();
+
+/**
+ * @brief Get the address of an OpenGL function from the active backend.
+ * 
+ * @param name  The name of the OpenGL function.
+ * @return The function address, or nullptr if not found.
+ */
+void* getProcAddress(const char* name);
+
+/**
+ * @brief Check whether current context supports the OpenGL extension.
+ * 
+ * @param name  The name of the extension, such as "GL_ARB_shader_viewport_layer_array".
+ */
+bool hasExtension(const char* name);
 
 /**
  * @brief Calling glfwTerminate() to destroy all remaining windows and context, while
@@ -21,6 +21,7 @@
  * 
  * 2022.4.29 Refactor the codes:
  *   # Complete the doxygen comments;
+ * 2026.10.16 Make VAVBEBO movable and non-copyable, since it owns the GL objects.
  * ------------------------------------------------------------------------------------*/
 #ifndef GL_UTIL_VAVBEBO_H_LF
 #define GL_UTIL_VAVBEBO_H_LF
@@ -37,6 +38,29 @@ public:
      */
     VAVBEBO();
 
+    /**
+     * @brief Delete copy constructor.
+     *
+     * @note VAVBEBO owns the VAO, VBO and EBO, a copy would delete them twice.
+     */
+    VAVBEBO(const VAVBEBO&) = delete;
+
+    /**
+     * @brief Delete assignment constructor.
+     */
+    VAVBEBO& operator=(const VAVBEBO&) = delete;
+
+    /**
+     * @brief Move constructor, the GL objects are taken from the other VAVBEBO, which
+     * is left without vertices bound.
+     */
+    VAVBEBO(VAVBEBO&& other) noexcept;
+
+    /**
+     * @brief Move assignment, the GL objects of this VAVBEBO are deleted first.
+     */
+    VAVBEBO& operator=(VAVBEBO&& other) noexcept;
+
     /**
      * @brief Destroy the VAVBEBO object.
      * 
@@ -79,6 +103,9 @@ public:
     void unBindVertexArray();
 
 private:
+    /* Exchange the GL objects with the other VAVBEBO */
+    void swap(VAVBEBO& other) noexcept;
+
     GLuint _vao;        ///< Vertex Array Object
     GLuint _vbo;        ///< Vertex Buffer Object
     GLuint _ebo;        ///< Element Buffer Object
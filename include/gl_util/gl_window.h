@@ -19,6 +19,10 @@
  * --------------------------------------------------------------------------------------
  * Change History:                        
  * 
+ * 2026.10.16 Add per-window present mode (vsync/adaptive/uncapped) and frame limiter.
+ * 2026.10.16 Add event queue fed by gl_util::EventLoop, refresh() then only swaps.
+ * 2026.10.16 Add opt-in render thread with independent context per window.
+ * 2026.10.16 Add setProfiler() to record frames between clear() and refresh().
  * 2022.4.29 Add interface to enable/disable DepthTest, so that the 
  *   depth buffer will also be clear when the Window::clear() be called.
  * 2022.4.28 Refactor the codes:
@@ -36,14 +40,35 @@
 #include <cstdint>
 #include <string>
 #include <functional>
+#include <chrono>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
 #include "gl_util_ns.h"
+#include "gl_event_loop.h"
 
 struct GLFWwindow;
 
 GL_UTIL_BEGIN
 
+class Profiler;
+class RenderThread;
+
 typedef std::function<void(GLFWwindow* window)> CallbackKeyboardEvent;
 
+/**
+ * @brief The way a window presents the swapped buffers.
+ */
+enum PresentMode {
+    PRESENT_VSYNC,      ///< Wait for vertical blank, no tearing (swap interval 1).
+    PRESENT_ADAPTIVE,   ///< Wait for vertical blank, but swap at once if the frame is 
+                        ///< late (swap interval -1, EXT_swap_control_tear). Falls back
+                        ///< to PRESENT_VSYNC if not supported.
+    PRESENT_UNCAPPED,   ///< Swap at once, may tear (swap interval 0).
+    PRESENT_DEFAULT     ///< The driver's default, until another mode is set.
+};
+
 /**
  * @brief A windows class which help to manage GLFWwindow object.
  */
@@ -129,7 +154,8 @@ public:
      * 
      * @note OpenGL adopts double-buffers to store the rendered image to avoid the 
      * display flickering that may occur in single buffer mode. Calling this function 
-     * will invoke glfwSwapBuffers in activated window.
+     * will invoke glfwSwapBuffers in activated window. The events are also polled, 
+     * unless the window is attached to a gl_util::EventLoop.
      */
     void refresh();
 
@@ -200,6 +226,39 @@ public:
      */
     bool setToFullScreen(uint8_t monitor_id = 0);
     
+    /**
+     * @brief Set the present mode of this window.
+     * 
+     * @details The swap interval belongs to the context, so it is applied by the next
+     * refresh() of this window. Before this function is called, the driver's default
+     * is used.
+     * 
+     * @param mode  The present mode.
+     */
+    void setPresentMode(PresentMode mode);
+
+    /**
+     * @brief Get the present mode that is in effect.
+     * 
+     * @note PRESENT_ADAPTIVE becomes PRESENT_VSYNC once refresh() finds that the
+     * driver does not support it.
+     * @return PRESENT_DEFAULT if no mode is set by setPresentMode().
+     */
+    PresentMode presentMode() const;
+
+    /**
+     * @brief Limit the frame rate of this window, generally used with 
+     * PRESENT_UNCAPPED to present at a rate other than the display rate, e.g. the 
+     * camera rate.
+     * 
+     * @details refresh() sleeps until shortly before the deadline of the frame, and
+     * then spins to the deadline precisely, before swapping the buffers. If a frame is
+     * later than a whole period, the limiter restarts from it instead of catching up.
+     * 
+     * @param fps  The target frame rate, 0 to disable the limiter.
+     */
+    void setFrameLimit(float fps);
+
     /**
      * @brief Set the keyboard event call back
      * 
@@ -210,11 +269,88 @@ public:
      */
     void setKeyboardEventCallBack(CallbackKeyboardEvent callbackfunc);
 
+    /**
+     * @brief Set the profiler that records a frame from each clear() to the next 
+     * refresh().
+     * 
+     * @param profiler  The profiler, nullptr to stop profiling. The profiler should 
+     * outlive the window, and should not be shared with other windows.
+     */
+    void setProfiler(Profiler* profiler);
+
+    /**
+     * @brief Start a dedicated render thread which owns the context of this window.
+     * 
+     * @details After that, rendering of this window should be submitted as tasks by
+     * submit(), which run in order on the render thread, including clear() and 
+     * refresh(). Windows with their own render threads render and present in 
+     * parallel, instead of waiting for the swap of each other.
+     * 
+     * @note 
+     * - The context will be released from the calling thread if it is current.
+     * - Textures, buffers and shader programs are shared between the windows, while 
+     *   container objects, i.e. VAO and FBO, are not, so create them in tasks.
+     * - GLFW events can only be processed on the main thread. On the render thread, 
+     *   refresh() only swaps buffers, and clear() does not process keyboard events, 
+     *   so keep calling glfwPollEvents() on the main thread.
+     * 
+     * @return 
+     *   @retval true  If the render thread is started or is already running.
+     *   @retval false Otherwise.
+     */
+    bool startRenderThread();
+
+    /**
+     * @brief Run the remaining tasks and stop the render thread. The context is not 
+     * current on any thread afterwards.
+     */
+    void stopRenderThread();
+
+    /**
+     * @brief Check whether the window has a render thread.
+     */
+    bool hasRenderThread() const;
+
+    /**
+     * @brief Submit a task to the render thread. If there is no render thread, the 
+     * task runs immediately on the calling thread with this window activated.
+     * 
+     * @param task  The task to render this window.
+     * @return The future that becomes ready when the task is done.
+     */
+    std::future<void> submit(std::function<void()> task);
+
+    /**
+     * @brief Block until all the submitted tasks are done.
+     */
+    void wait();
+
+    /**
+     * @brief Pop the oldest event dispatched by gl_util::EventLoop to this window.
+     * 
+     * @note This function is thread-safe.
+     * 
+     * @param[out] event  The event.
+     * @return 
+     *   @retval true  If an event is popped.
+     *   @retval false If the queue is empty.
+     */
+    bool popEvent(Event& event);
+
 private:
+    friend class EventLoop;
+
+    /* Push an event to the queue, called by EventLoop */
+    void pushEvent(const Event& event);
+
     /* Create GLFW window */ 
     bool createGLFWwindow();
     /* Process keyboar event */
     void processKeyboardEvent();
+    /* Apply the swap interval to the context of this window */
+    void applyPresentMode();
+    /* Wait for the deadline of frame limiter */
+    void waitFrameDeadline();
 
 public:
     const uint16_t    width;     ///< The width of the window
@@ -235,6 +371,19 @@ private:
 
     // The callback function for keyboard event
     CallbackKeyboardEvent    _callback_kbe;
+
+    Profiler* _profiler;         ///< The profiler of frames
+
+    std::unique_ptr<RenderThread> _render_thread; ///< The dedicated render thread
+
+    PresentMode _present_mode;           ///< The present mode
+    bool        _is_present_mode_dirty;  ///< Whether the swap interval should be set
+    std::chrono::steady_clock::duration   _frame_period;   ///< 0 if no frame limit
+    std::chrono::steady_clock::time_point _frame_deadline; ///< The next present time
+
+    EventLoop*        _event_loop;   ///< The event loop attached to
+    std::deque<Event> _events;       ///< The queue of events
+    std::mutex        _event_mutex;  ///< The lock of the queue
 };
 
 GL_UTIL_END
@@ -0,0 +1,84 @@
+#include "../include/gl_util/gl_compute_shader.h"
+#include "../include/gl_util/gl_state_cache.h"
+
+GL_UTIL_BEGIN
+
+ComputeShader::ComputeShader()
+    : _group_size(0)
+    , _group_generation(0) {
+}
+
+bool ComputeShader::load(const std::string &cs_path, const ShaderDefines &defines) {
+    if(!loadAsync(cs_path, defines)) {
+        return false;
+    }
+    return finish();
+}
+
+bool ComputeShader::loadAsync(const std::string &cs_path, const ShaderDefines &defines) {
+    return loadStagesAsync({ ShaderStage(GL_COMPUTE_SHADER, cs_path) }, defines);
+}
+
+bool ComputeShader::loadFromSource(std::string_view cs_code, const ShaderDefines &defines) {
+    return loadStagesFromSource({ ShaderSource(GL_COMPUTE_SHADER, cs_code) }, defines);
+}
+
+bool ComputeShader::loadSpirv(const std::string &cs_spirv_path,
+                              const SpecializationConstants &constants,
+                              const std::string &cs_glsl_path) {
+    std::vector<ShaderStage> glsl_stages;
+    if(!cs_glsl_path.empty()) {
+        glsl_stages.emplace_back(GL_COMPUTE_SHADER, cs_glsl_path);
+    }
+    return Shader::loadSpirv({ ShaderStage(GL_COMPUTE_SHADER, cs_spirv_path) }, constants,
+                             glsl_stages);
+}
+
+glm::uvec3 ComputeShader::workGroupSize() const {
+    // Queried once per program, since the size only changes with a reload.
+    if(_group_generation != generation()) {
+        GLint size[3] = { 0, 0, 0 };
+        if(ID() != 0) {
+            glGetProgramiv(ID(), GL_COMPUTE_WORK_GROUP_SIZE, size);
+        }
+        _group_size = glm::uvec3(size[0], size[1], size[2]);
+        _group_generation = generation();
+    }
+    return _group_size;
+}
+
+void ComputeShader::dispatch(GLuint x, GLuint y, GLuint z) {
+    use();
+    if(ID() == 0) return;
+    glDispatchCompute(x, y, z);
+}
+
+void ComputeShader::dispatchThreads(GLuint width, GLuint height, GLuint depth) {
+    use();
+    if(ID() == 0) return;
+    glm::uvec3 size = workGroupSize();
+    glDispatchCompute((width + size.x - 1) / size.x, (height + size.y - 1) / size.y,
+                      (depth + size.z - 1) / size.z);
+}
+
+void ComputeShader::dispatchIndirect(GLuint buffer, GLintptr offset) {
+    use();
+    if(ID() == 0) return;
+    StateCache::current().bindBuffer(GL_DISPATCH_INDIRECT_BUFFER, buffer);
+    glDispatchComputeIndirect(offset);
+}
+
+void ComputeShader::memoryBarrier(GLbitfield barriers) {
+    glMemoryBarrier(barriers);
+}
+
+void ComputeShader::memoryBarrierByRegion(GLbitfield barriers) {
+    glMemoryBarrierByRegion(barriers);
+}
+
+void ComputeShader::bindImage(GLuint unit, GLuint texture, GLenum access, GLenum format,
+                              GLint level) {
+    glBindImageTexture(unit, texture, level, GL_TRUE, 0, access, format);
+}
+
+GL_UTIL_END
@@ -0,0 +1,384 @@
+#include "gl_depth_kernel.h"
+#include <limits>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define GL_UTIL_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define GL_UTIL_TARGET_AVX2
+#else
+#define GL_UTIL_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#elif defined(__ARM_NEON) || defined(__aarch64__)
+#define GL_UTIL_NEON
+#include <arm_neon.h>
+#endif
+
+GL_UTIL_BEGIN
+
+/* ----------------------------------------------------------------------------------- */
+/*                                    Scalar kernels                                   */
+/* ----------------------------------------------------------------------------------- */
+
+static void depthF32Scalar(const float* in, float* out, size_t n,
+                           float a, float b, float k) {
+    for(size_t i = 0; i < n; i++) {
+        out[i] = b / (a + k * in[i]);
+    }
+}
+
+static void depthU16Scalar(const uint16_t* in, float* out, size_t n,
+                           float a, float b, float k) {
+    for(size_t i = 0; i < n; i++) {
+        out[i] = b / (a + k * float(in[i]));
+    }
+}
+
+static void depthU32Scalar(const uint32_t* in, float* out, size_t n,
+                           float a, float b, float k, int shift) {
+    for(size_t i = 0; i < n; i++) {
+        out[i] = b / (a + k * float(in[i] >> shift));
+    }
+}
+
+static const float DEPTH_NAN = std::numeric_limits<float>::quiet_NaN();
+
+/* Pack a color as RGBA bytes, the alpha is 255 for RGB color */
+static inline uint32_t packColor(const uint8_t* color, uint8_t channels) {
+    uint32_t a = channels == 4 ? color[3] : 255;
+    return uint32_t(color[0]) | (uint32_t(color[1]) << 8) | 
+           (uint32_t(color[2]) << 16) | (a << 24);
+}
+
+static void unprojectXYZScalar(const float* depth, const float* xs, float y, 
+                               float far_cut, PointXYZ* out, size_t n) {
+    for(size_t i = 0; i < n; i++) {
+        float z = depth[i] < far_cut ? depth[i] : DEPTH_NAN;
+        out[i].x = xs[i] * z;
+        out[i].y = y * z;
+        out[i].z = z;
+    }
+}
+
+static void unprojectXYZRGBScalar(const float* depth, const float* xs, float y, 
+                                  float far_cut, const uint8_t* color, uint8_t channels,
+                                  PointXYZRGB* out, size_t n) {
+    for(size_t i = 0; i < n; i++) {
+        float z = depth[i] < far_cut ? depth[i] : DEPTH_NAN;
+        out[i].x = xs[i] * z;
+        out[i].y = y * z;
+        out[i].z = z;
+        out[i].rgba = packColor(color + i * channels, channels);
+    }
+}
+
+/* ----------------------------------------------------------------------------------- */
+/*                                     SSE kernels                                     */
+/* ----------------------------------------------------------------------------------- */
+#ifdef GL_UTIL_X86
+
+/* Convert 4 uint32 to float, the SSE conversion is signed only */
+static inline __m128 cvtU32ToF32(__m128i v) {
+    __m128 hi = _mm_cvtepi32_ps(_mm_srli_epi32(v, 16));
+    __m128 lo = _mm_cvtepi32_ps(_mm_and_si128(v, _mm_set1_epi32(0xFFFF)));
+    return _mm_add_ps(_mm_mul_ps(hi, _mm_set1_ps(65536.f)), lo);
+}
+
+static void depthF32SSE(const float* in, float* out, size_t n,
+                        float a, float b, float k) {
+    const __m128 va = _mm_set1_ps(a), vb = _mm_set1_ps(b), vk = _mm_set1_ps(k);
+    size_t i = 0;
+    for(; i + 4 <= n; i += 4) {
+        __m128 z = _mm_loadu_ps(in + i);
+        _mm_storeu_ps(out + i, _mm_div_ps(vb, _mm_add_ps(va, _mm_mul_ps(vk, z))));
+    }
+    depthF32Scalar(in + i, out + i, n - i, a, b, k);
+}
+
+static void depthU16SSE(const uint16_t* in, float* out, size_t n,
+                        float a, float b, float k) {
+    const __m128 va = _mm_set1_ps(a), vb = _mm_set1_ps(b), vk = _mm_set1_ps(k);
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for(; i + 8 <= n; i += 8) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(in + i));
+        __m128 z0 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(v, zero));
+        __m128 z1 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(v, zero));
+        _mm_storeu_ps(out + i, _mm_div_ps(vb, _mm_add_ps(va, _mm_mul_ps(vk, z0))));
+        _mm_storeu_ps(out + i + 4, _mm_div_ps(vb, _mm_add_ps(va, _mm_mul_ps(vk, z1))));
+    }
+    depthU16Scalar(in + i, out + i, n - i, a, b, k);
+}
+
+static void depthU32SSE(const uint32_t* in, float* out, size_t n,
+                        float a, float b, float k, int shift) {
+    const __m128 va = _mm_set1_ps(a), vb = _mm_set1_ps(b), vk = _mm_set1_ps(k);
+    const __m128i count = _mm_cvtsi32_si128(shift);
+    size_t i = 0;
+    for(; i + 4 <= n; i += 4) {
+        __m128i v = _mm_srl_epi32(_mm_loadu_si128((const __m128i*)(in + i)), count);
+        __m128 z = cvtU32ToF32(v);
+        _mm_storeu_ps(out + i, _mm_div_ps(vb, _mm_add_ps(va, _mm_mul_ps(vk, z))));
+    }
+    depthU32Scalar(in + i, out + i, n - i, a, b, k, shift);
+}
+
+/* Compute x, y, z of 4 points, the background depth is replaced by NaN */
+static inline void unproject4SSE(const float* depth, const float* xs, __m128 vy,
+                                 __m128 vfar, __m128& x, __m128& y, __m128& z) {
+    __m128 d = _mm_loadu_ps(depth);
+    __m128 valid = _mm_cmplt_ps(d, vfar);
+    z = _mm_or_ps(_mm_and_ps(valid, d), 
+                  _mm_andnot_ps(valid, _mm_set1_ps(DEPTH_NAN)));
+    x = _mm_mul_ps(_mm_loadu_ps(xs), z);
+    y = _mm_mul_ps(vy, z);
+}
+
+static void unprojectXYZSSE(const float* depth, const float* xs, float y, 
+                            float far_cut, PointXYZ* out, size_t n) {
+    const __m128 vy = _mm_set1_ps(y), vfar = _mm_set1_ps(far_cut);
+    float* dst = &out[0].x;
+    size_t i = 0;
+    for(; i + 4 <= n; i += 4, dst += 12) {
+        __m128 x, yy, z;
+        unproject4SSE(depth + i, xs + i, vy, vfar, x, yy, z);
+        // Interleave to [x0 y0 z0 x1] [y1 z1 x2 y2] [z2 x3 y3 z3]
+        __m128 xy_lo = _mm_unpacklo_ps(x, yy);
+        __m128 xy_hi = _mm_unpackhi_ps(x, yy);
+        __m128 zx01 = _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0));
+        __m128 yz11 = _mm_shuffle_ps(yy, z, _MM_SHUFFLE(1, 1, 1, 1));
+        __m128 zx23 = _mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2));
+        __m128 yz33 = _mm_shuffle_ps(yy, z, _MM_SHUFFLE(3, 3, 3, 3));
+        _mm_storeu_ps(dst, _mm_shuffle_ps(xy_lo, zx01, _MM_SHUFFLE(2, 0, 1, 0)));
+        _mm_storeu_ps(dst + 4, _mm_shuffle_ps(yz11, xy_hi, _MM_SHUFFLE(1, 0, 2, 0)));
+        _mm_storeu_ps(dst + 8, _mm_shuffle_ps(zx23, yz33, _MM_SHUFFLE(2, 0, 2, 0)));
+    }
+    unprojectXYZScalar(depth + i, xs + i, y, far_cut, out + i, n - i);
+}
+
+static void unprojectXYZRGBSSE(const float* depth, const float* xs, float y, 
+                               float far_cut, const uint8_t* color, uint8_t channels,
+                               PointXYZRGB* out, size_t n) {
+    const __m128 vy = _mm_set1_ps(y), vfar = _mm_set1_ps(far_cut);
+    float* dst = &out[0].x;
+    size_t i = 0;
+    for(; i + 4 <= n; i += 4, dst += 16) {
+        __m128 x, yy, z;
+        unproject4SSE(depth + i, xs + i, vy, vfar, x, yy, z);
+        const uint8_t* src = color + i * channels;
+        __m128i c = channels == 4 ? 
+            _mm_loadu_si128((const __m128i*)src) :
+            _mm_set_epi32(packColor(src + 9, 3), packColor(src + 6, 3), 
+                          packColor(src + 3, 3), packColor(src, 3));
+        __m128 rgba = _mm_castsi128_ps(c);
+        // Each point is a row of [x y z rgba]
+        _MM_TRANSPOSE4_PS(x, yy, z, rgba);
+        _mm_storeu_ps(dst, x);
+        _mm_storeu_ps(dst + 4, yy);
+        _mm_storeu_ps(dst + 8, z);
+        _mm_storeu_ps(dst + 12, rgba);
+    }
+    unprojectXYZRGBScalar(depth + i, xs + i, y, far_cut, color + i * channels, 
+                          channels, out + i, n - i);
+}
+
+/* ----------------------------------------------------------------------------------- */
+/*                                    AVX2 kernels                                     */
+/* ----------------------------------------------------------------------------------- */
+
+GL_UTIL_TARGET_AVX2
+static void depthF32AVX2(const float* in, float* out, size_t n,
+                         float a, float b, float k) {
+    const __m256 va = _mm256_set1_ps(a), vb = _mm256_set1_ps(b), vk = _mm256_set1_ps(k);
+    size_t i = 0;
+    for(; i + 8 <= n; i += 8) {
+        __m256 z = _mm256_loadu_ps(in + i);
+        __m256 den = _mm256_add_ps(va, _mm256_mul_ps(vk, z));
+        _mm256_storeu_ps(out + i, _mm256_div_ps(vb, den));
+    }
+    depthF32Scalar(in + i, out + i, n - i, a, b, k);
+}
+
+GL_UTIL_TARGET_AVX2
+static void depthU16AVX2(const uint16_t* in, float* out, size_t n,
+                         float a, float b, float k) {
+    const __m256 va = _mm256_set1_ps(a), vb = _mm256_set1_ps(b), vk = _mm256_set1_ps(k);
+    size_t i = 0;
+    for(; i + 8 <= n; i += 8) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(in + i));
+        __m256 z = _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(v));
+        __m256 den = _mm256_add_ps(va, _mm256_mul_ps(vk, z));
+        _mm256_storeu_ps(out + i, _mm256_div_ps(vb, den));
+    }
+    depthU16Scalar(in + i, out + i, n - i, a, b, k);
+}
+
+GL_UTIL_TARGET_AVX2
+static void depthU32AVX2(const uint32_t* in, float* out, size_t n,
+                         float a, float b, float k, int shift) {
+    const __m256 va = _mm256_set1_ps(a), vb = _mm256_set1_ps(b), vk = _mm256_set1_ps(k);
+    const __m256i mask = _mm256_set1_epi32(0xFFFF);
+    const __m256 scale = _mm256_set1_ps(65536.f);
+    const __m128i count = _mm_cvtsi32_si128(shift);
+    size_t i = 0;
+    for(; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_srl_epi32(_mm256_loadu_si256((const __m256i*)(in + i)), count);
+        __m256 hi = _mm256_cvtepi32_ps(_mm256_srli_epi32(v, 16));
+        __m256 lo = _mm256_cvtepi32_ps(_mm256_and_si256(v, mask));
+        __m256 z = _mm256_add_ps(_mm256_mul_ps(hi, scale), lo);
+        __m256 den = _mm256_add_ps(va, _mm256_mul_ps(vk, z));
+        _mm256_storeu_ps(out + i, _mm256_div_ps(vb, den));
+    }
+    depthU32Scalar(in + i, out + i, n - i, a, b, k, shift);
+}
+
+/**
+ * @brief Check whether the CPU and OS support AVX2.
+ */
+static bool hasAVX2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if(info[0] < 7) return false;
+    __cpuid(info, 1);
+    if((info[2] & (1 << 27)) == 0) return false;
+    // The OS should save the YMM registers.
+    if((_xgetbv(0) & 0x6) != 0x6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // GL_UTIL_X86
+
+/* ----------------------------------------------------------------------------------- */
+/*                                    NEON kernels                                     */
+/* ----------------------------------------------------------------------------------- */
+#ifdef GL_UTIL_NEON
+
+/* Newton-Raphson refined reciprocal, since ARMv7 NEON has no division */
+static inline float32x4_t divNEON(float32x4_t num, float32x4_t den) {
+#if defined(__aarch64__)
+    return vdivq_f32(num, den);
+#else
+    float32x4_t r = vrecpeq_f32(den);
+    r = vmulq_f32(vrecpsq_f32(den, r), r);
+    r = vmulq_f32(vrecpsq_f32(den, r), r);
+    return vmulq_f32(num, r);
+#endif
+}
+
+static void depthF32NEON(const float* in, float* out, size_t n,
+                         float a, float b, float k) {
+    const float32x4_t va = vdupq_n_f32(a), vb = vdupq_n_f32(b);
+    size_t i = 0;
+    for(; i + 4 <= n; i += 4) {
+        float32x4_t z = vld1q_f32(in + i);
+        vst1q_f32(out + i, divNEON(vb, vmlaq_n_f32(va, z, k)));
+    }
+    depthF32Scalar(in + i, out + i, n - i, a, b, k);
+}
+
+static void depthU16NEON(const uint16_t* in, float* out, size_t n,
+                         float a, float b, float k) {
+    const float32x4_t va = vdupq_n_f32(a), vb = vdupq_n_f32(b);
+    size_t i = 0;
+    for(; i + 8 <= n; i += 8) {
+        uint16x8_t v = vld1q_u16(in + i);
+        float32x4_t z0 = vcvtq_f32_u32(vmovl_u16(vget_low_u16(v)));
+        float32x4_t z1 = vcvtq_f32_u32(vmovl_u16(vget_high_u16(v)));
+        vst1q_f32(out + i, divNEON(vb, vmlaq_n_f32(va, z0, k)));
+        vst1q_f32(out + i + 4, divNEON(vb, vmlaq_n_f32(va, z1, k)));
+    }
+    depthU16Scalar(in + i, out + i, n - i, a, b, k);
+}
+
+static void depthU32NEON(const uint32_t* in, float* out, size_t n,
+                         float a, float b, float k, int shift) {
+    const float32x4_t va = vdupq_n_f32(a), vb = vdupq_n_f32(b);
+    const int32x4_t count = vdupq_n_s32(-shift);
+    size_t i = 0;
+    for(; i + 4 <= n; i += 4) {
+        uint32x4_t v = vshlq_u32(vld1q_u32(in + i), count);
+        float32x4_t z = vcvtq_f32_u32(v);
+        vst1q_f32(out + i, divNEON(vb, vmlaq_n_f32(va, z, k)));
+    }
+    depthU32Scalar(in + i, out + i, n - i, a, b, k, shift);
+}
+
+/* Compute x, y, z of 4 points, the background depth is replaced by NaN */
+static inline void unproject4NEON(const float* depth, const float* xs, float y,
+                                  float32x4_t vfar, float32x4x3_t& p) {
+    float32x4_t d = vld1q_f32(depth);
+    p.val[2] = vbslq_f32(vcltq_f32(d, vfar), d, vdupq_n_f32(DEPTH_NAN));
+    p.val[0] = vmulq_f32(vld1q_f32(xs), p.val[2]);
+    p.val[1] = vmulq_n_f32(p.val[2], y);
+}
+
+static void unprojectXYZNEON(const float* depth, const float* xs, float y, 
+                             float far_cut, PointXYZ* out, size_t n) {
+    const float32x4_t vfar = vdupq_n_f32(far_cut);
+    size_t i = 0;
+    for(; i + 4 <= n; i += 4) {
+        float32x4x3_t p;
+        unproject4NEON(depth + i, xs + i, y, vfar, p);
+        vst3q_f32(&out[i].x, p);
+    }
+    unprojectXYZScalar(depth + i, xs + i, y, far_cut, out + i, n - i);
+}
+
+static void unprojectXYZRGBNEON(const float* depth, const float* xs, float y, 
+                                float far_cut, const uint8_t* color, uint8_t channels,
+                                PointXYZRGB* out, size_t n) {
+    const float32x4_t vfar = vdupq_n_f32(far_cut);
+    size_t i = 0;
+    for(; i + 4 <= n; i += 4) {
+        float32x4x3_t p;
+        unproject4NEON(depth + i, xs + i, y, vfar, p);
+        const uint8_t* src = color + i * channels;
+        uint32_t c[4];
+        for(int j = 0; j < 4; j++) {
+            c[j] = packColor(src + j * channels, channels);
+        }
+        float32x4x4_t q = {{p.val[0], p.val[1], p.val[2], 
+                            vreinterpretq_f32_u32(vld1q_u32(c))}};
+        vst4q_f32(&out[i].x, q);
+    }
+    unprojectXYZRGBScalar(depth + i, xs + i, y, far_cut, color + i * channels, 
+                          channels, out + i, n - i);
+}
+
+#endif // GL_UTIL_NEON
+
+/* ----------------------------------------------------------------------------------- */
+/*                                   Runtime dispatch                                  */
+/* ----------------------------------------------------------------------------------- */
+
+static DepthKernels selectDepthKernels() {
+#if defined(GL_UTIL_X86)
+    if(hasAVX2()) {
+        // The unprojection is bound by the interleaved stores, SSE is enough.
+        return {depthF32AVX2, depthU16AVX2, depthU32AVX2, 
+                unprojectXYZSSE, unprojectXYZRGBSSE, "AVX2"};
+    }
+    return {depthF32SSE, depthU16SSE, depthU32SSE, 
+            unprojectXYZSSE, unprojectXYZRGBSSE, "SSE2"};
+#elif defined(GL_UTIL_NEON)
+    return {depthF32NEON, depthU16NEON, depthU32NEON, 
+            unprojectXYZNEON, unprojectXYZRGBNEON, "NEON"};
+#else
+    return {depthF32Scalar, depthU16Scalar, depthU32Scalar, 
+            unprojectXYZScalar, unprojectXYZRGBScalar, "Scalar"};
+#endif
+}
+
+const DepthKernels& depthKernels() {
+    static const DepthKernels kernels = selectDepthKernels();
+    return kernels;
+}
+
+GL_UTIL_END
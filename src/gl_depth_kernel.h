@@ -0,0 +1,58 @@
+/** -------------------------------------------------------------------------------------
+ *
+ *   				                 OpenGL Utilities
+ *
+ * @file 		gl_depth_kernel.h
+ *
+ * @brief 		The internal SIMD kernels to linearize and unproject depth buffer.
+ *
+ * @author		Longfei Wang
+ *
+ * @version		1.0.0
+ *
+ * @date		2026/10/16
+ *
+ * @license		MIT
+ *
+ * Copyright (C) 2021-Now Longfei Wang.
+ * ------------------------------------------------------------------------------------*/
+#ifndef GL_UTIL_DEPTH_KERNEL_H_LF
+#define GL_UTIL_DEPTH_KERNEL_H_LF
+#include <cstddef>
+#include <cstdint>
+#include "../include/gl_util/gl_projection.h"
+
+GL_UTIL_BEGIN
+
+/**
+ * @brief The kernels to compute out[i] = b / (a + k * in[i]).
+ *
+ * @details With a = A - 1, b = B and k = 2 * normalize_scale, the result equals
+ * gl_util::Projection::cvt2RealDepth() of the normalized depth value.
+ */
+struct DepthKernels {
+    /* Input of GL_FLOAT depth */
+    void (*f32)(const float* in, float* out, size_t n, float a, float b, float k);
+    /* Input of GL_UNSIGNED_SHORT depth, i.e. GL_DEPTH_COMPONENT16 */
+    void (*u16)(const uint16_t* in, float* out, size_t n, float a, float b, float k);
+    /* Input of GL_UNSIGNED_INT depth, shifted right by 'shift' bits before use */
+    void (*u32)(const uint32_t* in, float* out, size_t n, float a, float b, float k,
+                int shift);
+    /* Back-project a row of real depth, i.e. out[i] = (xs[i]*d, y*d, d). The depth 
+       not less than 'far_cut' is regarded as background and set to NaN */
+    void (*xyz)(const float* depth, const float* xs, float y, float far_cut,
+                PointXYZ* out, size_t n);
+    /* Back-project a row of real depth with a row of RGB/RGBA color */
+    void (*xyzrgb)(const float* depth, const float* xs, float y, float far_cut,
+                   const uint8_t* color, uint8_t channels, PointXYZRGB* out, size_t n);
+    const char* name;   ///< The instruction set, for logging
+};
+
+/**
+ * @brief Get the kernels for the best instruction set of the running CPU.
+ * The CPU is detected once, on the first call.
+ */
+const DepthKernels& depthKernels();
+
+GL_UTIL_END
+#endif // GL_UTIL_DEPTH_KERNEL_H_LF
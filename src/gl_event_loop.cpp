@@ -0,0 +1,159 @@
+#include "../include/gl_util/gl_event_loop.h"
+#include "../include/gl_util/gl_window.h"
+#include <algorithm>
+
+GL_UTIL_BEGIN
+
+/* ----------------------------------------------------------------------------------- */
+/*                                    GLFW callbacks                                   */
+/* ----------------------------------------------------------------------------------- */
+
+/**
+ * @brief Create an event of the type, timestamped with current time.
+ */
+static Event makeEvent(Event::Type type) {
+    Event event = {};
+    event.type = type;
+    event.time = glfwGetTime();
+    return event;
+}
+
+struct EventLoop::Callbacks {
+    static void onKey(GLFWwindow* window, int key, int scancode, int action, int mods) {
+        Event event = makeEvent(Event::KEY);
+        event.key = key;
+        event.scancode = scancode;
+        event.action = action;
+        event.mods = mods;
+        dispatch(window, event);
+    }
+
+    static void onChar(GLFWwindow* window, unsigned int codepoint) {
+        Event event = makeEvent(Event::CHAR);
+        event.codepoint = codepoint;
+        dispatch(window, event);
+    }
+
+    static void onMouseButton(GLFWwindow* window, int button, int action, int mods) {
+        Event event = makeEvent(Event::MOUSE_BUTTON);
+        event.key = button;
+        event.action = action;
+        event.mods = mods;
+        dispatch(window, event);
+    }
+
+    static void onCursorPos(GLFWwindow* window, double x, double y) {
+        Event event = makeEvent(Event::CURSOR_POS);
+        event.x = x;
+        event.y = y;
+        dispatch(window, event);
+    }
+
+    static void onScroll(GLFWwindow* window, double x, double y) {
+        Event event = makeEvent(Event::SCROLL);
+        event.x = x;
+        event.y = y;
+        dispatch(window, event);
+    }
+
+    static void onResize(GLFWwindow* window, int width, int height) {
+        Event event = makeEvent(Event::RESIZE);
+        event.x = width;
+        event.y = height;
+        dispatch(window, event);
+    }
+
+    static void onFocus(GLFWwindow* window, int focused) {
+        Event event = makeEvent(Event::FOCUS);
+        event.action = focused;
+        dispatch(window, event);
+    }
+
+    static void onClose(GLFWwindow* window) {
+        dispatch(window, makeEvent(Event::CLOSE));
+    }
+
+    /* Set or clear all the callbacks of the window */
+    static void install(GLFWwindow* window, bool enable) {
+        glfwSetKeyCallback(window, enable ? onKey : nullptr);
+        glfwSetCharCallback(window, enable ? onChar : nullptr);
+        glfwSetMouseButtonCallback(window, enable ? onMouseButton : nullptr);
+        glfwSetCursorPosCallback(window, enable ? onCursorPos : nullptr);
+        glfwSetScrollCallback(window, enable ? onScroll : nullptr);
+        glfwSetWindowSizeCallback(window, enable ? onResize : nullptr);
+        glfwSetWindowFocusCallback(window, enable ? onFocus : nullptr);
+        glfwSetWindowCloseCallback(window, enable ? onClose : nullptr);
+    }
+};
+
+/* ----------------------------------------------------------------------------------- */
+/*                                EventLoop implementation                             */
+/* ----------------------------------------------------------------------------------- */
+
+EventLoop::EventLoop()
+    : _pump_count(0) {
+    checkInitStatus();
+}
+
+EventLoop::~EventLoop() {
+    while(!_windows.empty()) {
+        detach(*_windows.back());
+    }
+}
+
+void EventLoop::attach(Window& window) {
+    if(window._event_loop == this) {
+        return;
+    }
+    if(window._event_loop) {
+        window._event_loop->detach(window);
+    }
+    glfwSetWindowUserPointer(window.ptr(), &window);
+    Callbacks::install(window.ptr(), true);
+    window._event_loop = this;
+    _windows.push_back(&window);
+}
+
+void EventLoop::detach(Window& window) {
+    auto iter = std::find(_windows.begin(), _windows.end(), &window);
+    if(iter == _windows.end()) {
+        return;
+    }
+    Callbacks::install(window.ptr(), false);
+    glfwSetWindowUserPointer(window.ptr(), nullptr);
+    window._event_loop = nullptr;
+    _windows.erase(iter);
+}
+
+void EventLoop::poll() {
+    _pump_count++;
+    glfwPollEvents();
+}
+
+void EventLoop::wait() {
+    _pump_count++;
+    glfwWaitEvents();
+}
+
+void EventLoop::wait(double timeout) {
+    _pump_count++;
+    glfwWaitEventsTimeout(timeout);
+}
+
+void EventLoop::wakeUp() {
+    glfwPostEmptyEvent();
+}
+
+uint64_t EventLoop::pumpCount() const {
+    return _pump_count;
+}
+
+// --- PRIVATE ---
+void EventLoop::dispatch(GLFWwindow* window, const Event& event) {
+    Window* target = static_cast<Window*>(glfwGetWindowUserPointer(window));
+    if(target) {
+        target->pushEvent(event);
+    }
+}
+
+GL_UTIL_END
@@ -0,0 +1,176 @@
+#include "../include/gl_util/gl_file_watcher.h"
+#include <filesystem>
+#ifdef __linux__
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+GL_UTIL_BEGIN
+
+/* ----------------------------------------------------------------------------------- */
+/*                                 FileWatcher utility                                 */
+/* ----------------------------------------------------------------------------------- */
+
+#ifdef __linux__
+/** A write by the editor, or a file renamed over the watched one **/
+static const uint32_t WATCH_MASK = IN_CLOSE_WRITE | IN_MOVED_TO;
+#endif
+
+/**
+ * @brief Split the path into the normalized absolute parent directory and the name.
+ */
+static void splitPath(const std::string& path, std::string& directory, std::string& name) {
+    std::error_code error;
+    fs::path absolute = fs::absolute(path, error).lexically_normal();
+    directory = fs::weakly_canonical(absolute.parent_path(), error).string();
+    name = absolute.filename().string();
+}
+
+/* ----------------------------------------------------------------------------------- */
+/*                              FileWatcher implementation                             */
+/* ----------------------------------------------------------------------------------- */
+
+FileWatcher& FileWatcher::shared() {
+    static FileWatcher watcher;
+    return watcher;
+}
+
+FileWatcher::FileWatcher()
+    : _fd(-1)
+    , _wake_fd(-1)
+    , _next_id(1) {
+}
+
+FileWatcher::~FileWatcher() {
+#ifdef __linux__
+    if(_thread.joinable()) {
+        uint64_t value = 1;
+        if(write(_wake_fd, &value, sizeof(value)) < 0) {
+            GL_UTIL_LOG("ERROR: Failed to wake up the file watcher thread!\n");
+        }
+        _thread.join();
+    }
+    if(_fd >= 0) close(_fd);
+    if(_wake_fd >= 0) close(_wake_fd);
+#endif
+}
+
+uint64_t FileWatcher::watch(const std::string& path, Callback callback) {
+#ifdef __linux__
+    std::lock_guard<std::mutex> lock(_mutex);
+    if(!start()) {
+        return 0;
+    }
+
+    Entry entry;
+    splitPath(path, entry.directory, entry.name);
+    entry.callback = std::move(callback);
+    if(_directories.find(entry.directory) == _directories.end()) {
+        int wd = inotify_add_watch(_fd, entry.directory.c_str(), WATCH_MASK);
+        if(wd < 0) {
+            GL_UTIL_LOG("ERROR: Cannot watch the directory: %s\n", entry.directory.c_str());
+            return 0;
+        }
+        _directories[entry.directory] = wd;
+    }
+    uint64_t id = _next_id++;
+    _entries[id] = std::move(entry);
+    return id;
+#else
+    (void)callback;
+    GL_UTIL_LOG("WARNING: File watching is not supported, %s is not watched.\n",
+                path.c_str());
+    return 0;
+#endif
+}
+
+void FileWatcher::unwatch(uint64_t id) {
+#ifdef __linux__
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto iter = _entries.find(id);
+    if(iter == _entries.end()) {
+        return;
+    }
+    std::string directory = iter->second.directory;
+    _entries.erase(iter);
+    // Stop watching the directory once no file in it is watched.
+    for(const auto& item : _entries) {
+        if(item.second.directory == directory) return;
+    }
+    auto dir_iter = _directories.find(directory);
+    if(dir_iter != _directories.end()) {
+        inotify_rm_watch(_fd, dir_iter->second);
+        _directories.erase(dir_iter);
+    }
+#else
+    (void)id;
+#endif
+}
+
+// --- PRIVATE ---
+bool FileWatcher::start() {
+#ifdef __linux__
+    if(_thread.joinable()) {
+        return true;
+    }
+    _fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    _wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if(_fd < 0 || _wake_fd < 0) {
+        GL_UTIL_LOG("ERROR: Failed to initialize inotify!\n");
+        return false;
+    }
+    _thread = std::thread(&FileWatcher::run, this);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void FileWatcher::run() {
+#ifdef __linux__
+    // Aligned as required by struct inotify_event.
+    alignas(struct inotify_event) char buffer[4096];
+    while(true) {
+        struct pollfd fds[2] = { { _fd, POLLIN, 0 }, { _wake_fd, POLLIN, 0 } };
+        if(poll(fds, 2, -1) < 0) {
+            continue;
+        }
+        if(fds[1].revents & POLLIN) {
+            break;
+        }
+
+        ssize_t length;
+        while((length = read(_fd, buffer, sizeof(buffer))) > 0) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            for(char* ptr = buffer; ptr < buffer + length;) {
+                const struct inotify_event* event = (const struct inotify_event*)ptr;
+                ptr += sizeof(struct inotify_event) + event->len;
+                if(event->len == 0) continue;
+
+                // Map the descriptor back to the directory.
+                const std::string* directory = nullptr;
+                for(const auto& item : _directories) {
+                    if(item.second == event->wd) {
+                        directory = &item.first;
+                        break;
+                    }
+                }
+                if(!directory) continue;
+
+                for(const auto& item : _entries) {
+                    const Entry& entry = item.second;
+                    if(entry.directory == *directory && entry.name == event->name) {
+                        entry.callback((fs::path(entry.directory) / entry.name).string());
+                    }
+                }
+            }
+        }
+    }
+#endif
+}
+
+GL_UTIL_END
@@ -0,0 +1,393 @@
+#include "../include/gl_util/gl_framebuffer.h"
+#include "../include/gl_util/gl_state_cache.h"
+#include <utility>
+
+GL_UTIL_BEGIN
+
+/* ----------------------------------------------------------------------------------- */
+/*                                  FrameBuffer utility                                */
+/* ----------------------------------------------------------------------------------- */
+
+/**
+ * @brief Check whether the internal format is a depth-stencil format.
+ */
+static bool isDepthStencilFormat(GLenum internal_format) {
+    return internal_format == GL_DEPTH24_STENCIL8 ||
+           internal_format == GL_DEPTH32F_STENCIL8;
+}
+
+/**
+ * @brief Get the pixel format and type that match the sized internal format, which
+ * are required by glTexImage2D even though no data is uploaded.
+ */
+static void getPixelFormat(GLenum internal_format, GLenum& format, GLenum& type) {
+    switch (internal_format) {
+    case GL_DEPTH_COMPONENT16:
+    case GL_DEPTH_COMPONENT24:
+    case GL_DEPTH_COMPONENT32:
+        format = GL_DEPTH_COMPONENT; type = GL_UNSIGNED_INT; break;
+    case GL_DEPTH_COMPONENT32F:
+        format = GL_DEPTH_COMPONENT; type = GL_FLOAT; break;
+    case GL_DEPTH24_STENCIL8:
+        format = GL_DEPTH_STENCIL; type = GL_UNSIGNED_INT_24_8; break;
+    case GL_DEPTH32F_STENCIL8:
+        format = GL_DEPTH_STENCIL; type = GL_FLOAT_32_UNSIGNED_INT_24_8_REV; break;
+    case GL_R8:     format = GL_RED;  type = GL_UNSIGNED_BYTE; break;
+    case GL_RG8:    format = GL_RG;   type = GL_UNSIGNED_BYTE; break;
+    case GL_RGB8:   format = GL_RGB;  type = GL_UNSIGNED_BYTE; break;
+    case GL_R16F:
+    case GL_R32F:   format = GL_RED;  type = GL_FLOAT; break;
+    case GL_RG16F:
+    case GL_RG32F:  format = GL_RG;   type = GL_FLOAT; break;
+    case GL_RGB16F:
+    case GL_RGB32F: format = GL_RGB;  type = GL_FLOAT; break;
+    case GL_RGBA16F:
+    case GL_RGBA32F: format = GL_RGBA; type = GL_FLOAT; break;
+    // The integer formats, e.g. for picking IDs, take the integer pixel formats.
+    case GL_R8UI:   format = GL_RED_INTEGER;  type = GL_UNSIGNED_BYTE; break;
+    case GL_R16UI:  format = GL_RED_INTEGER;  type = GL_UNSIGNED_SHORT; break;
+    case GL_R32UI:  format = GL_RED_INTEGER;  type = GL_UNSIGNED_INT; break;
+    case GL_R8I:    format = GL_RED_INTEGER;  type = GL_BYTE; break;
+    case GL_R16I:   format = GL_RED_INTEGER;  type = GL_SHORT; break;
+    case GL_R32I:   format = GL_RED_INTEGER;  type = GL_INT; break;
+    case GL_RG8UI:  format = GL_RG_INTEGER;   type = GL_UNSIGNED_BYTE; break;
+    case GL_RG16UI: format = GL_RG_INTEGER;   type = GL_UNSIGNED_SHORT; break;
+    case GL_RG32UI: format = GL_RG_INTEGER;   type = GL_UNSIGNED_INT; break;
+    case GL_RG8I:   format = GL_RG_INTEGER;   type = GL_BYTE; break;
+    case GL_RG16I:  format = GL_RG_INTEGER;   type = GL_SHORT; break;
+    case GL_RG32I:  format = GL_RG_INTEGER;   type = GL_INT; break;
+    case GL_RGBA8UI:  format = GL_RGBA_INTEGER; type = GL_UNSIGNED_BYTE; break;
+    case GL_RGBA16UI: format = GL_RGBA_INTEGER; type = GL_UNSIGNED_SHORT; break;
+    case GL_RGBA32UI: format = GL_RGBA_INTEGER; type = GL_UNSIGNED_INT; break;
+    case GL_RGBA8I:   format = GL_RGBA_INTEGER; type = GL_BYTE; break;
+    case GL_RGBA16I:  format = GL_RGBA_INTEGER; type = GL_SHORT; break;
+    case GL_RGBA32I:  format = GL_RGBA_INTEGER; type = GL_INT; break;
+    default:        format = GL_RGBA; type = GL_UNSIGNED_BYTE; break;
+    }
+}
+
+/* ----------------------------------------------------------------------------------- */
+/*                               FrameBuffer implementation                            */
+/* ----------------------------------------------------------------------------------- */
+
+FrameBuffer::FrameBuffer(uint16_t width, uint16_t height, uint8_t samples)
+    : _width(width)
+    , _height(height)
+    , _samples(samples)
+    , _fbo(0)
+    , _has_created(false)
+    , _depth({GL_DEPTH_COMPONENT24, STORAGE_RENDERBUFFER, 0})
+    , _has_depth(false) {
+    checkInitStatus();
+}
+
+FrameBuffer::FrameBuffer(FrameBuffer&& other) noexcept
+    : FrameBuffer(0, 0, 0) {
+    swap(other);
+}
+
+FrameBuffer& FrameBuffer::operator=(FrameBuffer&& other) noexcept {
+    // The GL objects of this FrameBuffer are deleted with the temporary.
+    FrameBuffer moved(std::move(other));
+    swap(moved);
+    return *this;
+}
+
+FrameBuffer::~FrameBuffer() {
+    if(!_has_created) return;
+
+    StateCache& cache = StateCache::current();
+    for(auto& color : _colors) {
+        if(color.storage == STORAGE_TEXTURE) cache.deleteTextures(1, &color.object);
+        else glDeleteRenderbuffers(1, &color.object);
+    }
+    if(_has_depth) {
+        if(_depth.storage == STORAGE_TEXTURE) cache.deleteTextures(1, &_depth.object);
+        else glDeleteRenderbuffers(1, &_depth.object);
+    }
+    glDeleteFramebuffers(1, &_fbo);
+}
+
+bool FrameBuffer::addColorAttachment(GLenum internal_format, Storage storage) {
+    if(_has_created) {
+        GL_UTIL_LOG("ERROR: Cannot add attachment after FrameBuffer is created!\n");
+        return false;
+    }
+    GLint max_attachments = 0;
+    glGetIntegerv(GL_MAX_COLOR_ATTACHMENTS, &max_attachments);
+    if((GLint)_colors.size() >= max_attachments) {
+        GL_UTIL_LOG("ERROR: At most %d color attachments are supported!\n",
+                    max_attachments);
+        return false;
+    }
+    _colors.push_back({internal_format, storage, 0});
+    return true;
+}
+
+bool FrameBuffer::setDepthAttachment(GLenum internal_format, Storage storage) {
+    if(_has_created) {
+        GL_UTIL_LOG("ERROR: Cannot set attachment after FrameBuffer is created!\n");
+        return false;
+    }
+    _depth = {internal_format, storage, 0};
+    _has_depth = true;
+    return true;
+}
+
+bool FrameBuffer::create() {
+    if(_has_created) {
+        GL_UTIL_LOG("WARNING: FrameBuffer has been created!\n");
+        return true;
+    }
+    if(_colors.empty()) {
+        addColorAttachment();
+    }
+
+    glGenFramebuffers(1, &_fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, _fbo);
+
+    std::vector<GLenum> draw_buffers(_colors.size());
+    for(size_t i = 0; i < _colors.size(); i++) {
+        if(_colors[i].storage == STORAGE_TEXTURE) glGenTextures(1, &_colors[i].object);
+        else glGenRenderbuffers(1, &_colors[i].object);
+        allocate(_colors[i]);
+        attach(_colors[i], GL_COLOR_ATTACHMENT0 + i);
+        draw_buffers[i] = GL_COLOR_ATTACHMENT0 + i;
+    }
+    glDrawBuffers(draw_buffers.size(), draw_buffers.data());
+
+    if(_has_depth) {
+        if(_depth.storage == STORAGE_TEXTURE) glGenTextures(1, &_depth.object);
+        else glGenRenderbuffers(1, &_depth.object);
+        allocate(_depth);
+        attach(_depth, isDepthStencilFormat(_depth.internal_format) ?
+               GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT);
+    }
+    _has_created = true;
+
+    bool ret = checkStatus();
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    // The resolve target always uses textures so that the results can be sampled.
+    if(_samples > 0) {
+        _resolved.reset(new FrameBuffer(_width, _height, 0));
+        for(const auto& color : _colors) {
+            _resolved->addColorAttachment(color.internal_format, STORAGE_TEXTURE);
+        }
+        if(_has_depth) {
+            _resolved->setDepthAttachment(_depth.internal_format, STORAGE_TEXTURE);
+        }
+        ret = _resolved->create() && ret;
+    }
+    return ret;
+}
+
+bool FrameBuffer::resize(uint16_t width, uint16_t height) {
+    if(width == _width && height == _height) {
+        return true;
+    }
+    _width = width;
+    _height = height;
+    if(!_has_created) {
+        return true;
+    }
+
+    for(auto& color : _colors) {
+        allocate(color);
+    }
+    if(_has_depth) {
+        allocate(_depth);
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, _fbo);
+    bool ret = checkStatus();
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if(_resolved) {
+        ret = _resolved->resize(width, height) && ret;
+    }
+    return ret;
+}
+
+void FrameBuffer::bind() {
+    if(!_has_created) {
+        GL_UTIL_LOG("ERROR: FrameBuffer is not created!\n");
+        return;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, _fbo);
+    glViewport(0, 0, _width, _height);
+}
+
+void FrameBuffer::unbind() {
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void FrameBuffer::clear(float R, float G, float B, float A) {
+    bind();
+    StateCache::current().clearColor(R, G, B, A);
+    GLbitfield mask = GL_COLOR_BUFFER_BIT;
+    if(_has_depth) {
+        mask |= GL_DEPTH_BUFFER_BIT;
+        if(isDepthStencilFormat(_depth.internal_format)) {
+            mask |= GL_STENCIL_BUFFER_BIT;
+        }
+    }
+    glClear(mask);
+}
+
+void FrameBuffer::resolve() {
+    if(!_resolved || !_has_created) return;
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, _fbo);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, _resolved->_fbo);
+    // Each color attachment is blitted separately, since a blit only reads one buffer.
+    for(size_t i = 0; i < _colors.size(); i++) {
+        GLenum buffer = GL_COLOR_ATTACHMENT0 + i;
+        glReadBuffer(buffer);
+        glDrawBuffers(1, &buffer);
+        GLbitfield mask = GL_COLOR_BUFFER_BIT;
+        if(i == 0 && _has_depth) {
+            mask |= GL_DEPTH_BUFFER_BIT;
+        }
+        glBlitFramebuffer(0, 0, _width, _height, 0, 0, _width, _height,
+                          mask, GL_NEAREST);
+    }
+    // Restore the draw buffers of the resolve target.
+    std::vector<GLenum> draw_buffers(_colors.size());
+    for(size_t i = 0; i < _colors.size(); i++) {
+        draw_buffers[i] = GL_COLOR_ATTACHMENT0 + i;
+    }
+    glDrawBuffers(draw_buffers.size(), draw_buffers.data());
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, _fbo);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void FrameBuffer::blitTo(GLuint dst_fbo, uint16_t dst_width, uint16_t dst_height,
+                         uint8_t index, GLenum filter) {
+    if(!_has_created || index >= _colors.size()) return;
+
+    // A multisampled framebuffer cannot be blitted with scaling, so the resolve
+    // target is read instead.
+    GLuint src_fbo = _fbo;
+    if(_resolved && (dst_width != _width || dst_height != _height)) {
+        resolve();
+        src_fbo = _resolved->_fbo;
+    }
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, src_fbo);
+    glReadBuffer(GL_COLOR_ATTACHMENT0 + index);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, dst_fbo);
+    glBlitFramebuffer(0, 0, _width, _height, 0, 0, dst_width, dst_height,
+                      GL_COLOR_BUFFER_BIT, filter);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+GLuint FrameBuffer::colorTexture(uint8_t index) const {
+    if(_resolved) return _resolved->colorTexture(index);
+    if(index >= _colors.size() || _colors[index].storage != STORAGE_TEXTURE) return 0;
+    return _colors[index].object;
+}
+
+GLuint FrameBuffer::depthTexture() const {
+    if(_resolved) return _resolved->depthTexture();
+    if(!_has_depth || _depth.storage != STORAGE_TEXTURE) return 0;
+    return _depth.object;
+}
+
+void FrameBuffer::bindColorTexture(uint8_t unit, uint8_t index) const {
+    StateCache::current().bindTextureUnit(unit, GL_TEXTURE_2D, colorTexture(index));
+}
+
+GLuint FrameBuffer::ID() const {
+    return _fbo;
+}
+
+GLuint FrameBuffer::resolvedID() const {
+    return _resolved ? _resolved->_fbo : _fbo;
+}
+
+uint16_t FrameBuffer::width() const {
+    return _width;
+}
+
+uint16_t FrameBuffer::height() const {
+    return _height;
+}
+
+uint8_t FrameBuffer::samples() const {
+    return _samples;
+}
+
+uint8_t FrameBuffer::colorCount() const {
+    return (uint8_t)_colors.size();
+}
+
+// --- PRIVATE ---
+void FrameBuffer::allocate(Attachment& attachment) {
+    StateCache& cache = StateCache::current();
+    if(attachment.storage == STORAGE_RENDERBUFFER) {
+        glBindRenderbuffer(GL_RENDERBUFFER, attachment.object);
+        if(_samples > 0) {
+            glRenderbufferStorageMultisample(GL_RENDERBUFFER, _samples,
+                attachment.internal_format, _width, _height);
+        }
+        else {
+            glRenderbufferStorage(GL_RENDERBUFFER, attachment.internal_format,
+                                  _width, _height);
+        }
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    }
+    else if(_samples > 0) {
+        cache.bindTexture(GL_TEXTURE_2D_MULTISAMPLE, attachment.object);
+        glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, _samples,
+            attachment.internal_format, _width, _height, GL_TRUE);
+        cache.bindTexture(GL_TEXTURE_2D_MULTISAMPLE, 0);
+    }
+    else {
+        GLenum format, type;
+        getPixelFormat(attachment.internal_format, format, type);
+        cache.bindTexture(GL_TEXTURE_2D, attachment.object);
+        glTexImage2D(GL_TEXTURE_2D, 0, attachment.internal_format, _width, _height, 0,
+                     format, type, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        cache.bindTexture(GL_TEXTURE_2D, 0);
+    }
+}
+
+void FrameBuffer::attach(const Attachment& attachment, GLenum attachment_point) {
+    if(attachment.storage == STORAGE_RENDERBUFFER) {
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, attachment_point, GL_RENDERBUFFER,
+                                  attachment.object);
+    }
+    else {
+        GLenum target = _samples > 0 ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
+        glFramebufferTexture2D(GL_FRAMEBUFFER, attachment_point, target,
+                               attachment.object, 0);
+    }
+}
+
+bool FrameBuffer::checkStatus() const {
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    if(status != GL_FRAMEBUFFER_COMPLETE) {
+        GL_UTIL_LOG("ERROR: FrameBuffer is not complete, status: 0x%x.\n", status);
+        return false;
+    }
+    return true;
+}
+
+void FrameBuffer::swap(FrameBuffer& other) noexcept {
+    std::swap(_width, other._width);
+    std::swap(_height, other._height);
+    std::swap(_samples, other._samples);
+    std::swap(_fbo, other._fbo);
+    std::swap(_has_created, other._has_created);
+    std::swap(_colors, other._colors);
+    std::swap(_depth, other._depth);
+    std::swap(_has_depth, other._has_depth);
+    std::swap(_resolved, other._resolved);
+}
+
+GL_UTIL_END
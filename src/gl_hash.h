@@ -0,0 +1,45 @@
+/** -------------------------------------------------------------------------------------
+ *
+ *   				                 OpenGL Utilities
+ *
+ * @file 		gl_hash.h
+ *
+ * @brief 		The internal string hash shared by the caches.
+ *
+ * @author		Longfei Wang
+ *
+ * @version		1.0.0
+ *
+ * @date		2026/10/16
+ *
+ * @license		MIT
+ *
+ * Copyright (C) 2021-Now Longfei Wang.
+ * ------------------------------------------------------------------------------------*/
+#ifndef GL_UTIL_HASH_H_LF
+#define GL_UTIL_HASH_H_LF
+#include <cstdint>
+#include <string_view>
+#include "../include/gl_util/gl_util_ns.h"
+
+GL_UTIL_BEGIN
+
+/** The initial value of hashString() **/
+constexpr uint64_t HASH_SEED = 0xcbf29ce484222325ull;
+
+/**
+ * @brief 64-bit FNV-1a hash of the string.
+ *
+ * @param str  The string.
+ * @param hash  The hash to continue from, for hashing several strings as one.
+ */
+inline uint64_t hashString(std::string_view str, uint64_t hash = HASH_SEED) {
+    for(char c : str) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+GL_UTIL_END
+#endif // GL_UTIL_HASH_H_LF
@@ -0,0 +1,296 @@
+#include "gl_headless.h"
+#include <vector>
+#ifdef GL_UTIL_WITH_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <cstring>
+#endif
+#ifdef GL_UTIL_WITH_OSMESA
+#include <glad/glad.h>
+#include <GL/osmesa.h>
+#endif
+
+GL_UTIL_BEGIN
+
+/* ----------------------------------------------------------------------------------- */
+/*                                     EGL backend                                     */
+/* ----------------------------------------------------------------------------------- */
+#ifdef GL_UTIL_WITH_EGL
+
+static EGLDisplay egl_display = EGL_NO_DISPLAY;
+static EGLContext egl_context = EGL_NO_CONTEXT;
+static EGLSurface egl_surface = EGL_NO_SURFACE;
+
+/**
+ * @brief Check whether the extension is in the space separated extension string.
+ */
+static bool hasEGLExtension(const char* extensions, const char* name) {
+    if(!extensions) return false;
+    size_t len = strlen(name);
+    for(const char* p = strstr(extensions, name); p; p = strstr(p + len, name)) {
+        bool starts = (p == extensions || p[-1] == ' ');
+        bool ends = (p[len] == ' ' || p[len] == '\0');
+        if(starts && ends) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Open an EGL display that does not rely on any window system.
+ *
+ * @details The Mesa surfaceless platform is preferred, then the first EGL device
+ * (render node), and the default display at last.
+ */
+static EGLDisplay openEGLDisplay() {
+    const char* client_ext = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    auto get_platform_display = (PFNEGLGETPLATFORMDISPLAYEXTPROC)
+        eglGetProcAddress("eglGetPlatformDisplayEXT");
+
+    if(get_platform_display) {
+        if(hasEGLExtension(client_ext, "EGL_MESA_platform_surfaceless")) {
+            EGLDisplay display = get_platform_display(
+                EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+            if(display != EGL_NO_DISPLAY && eglInitialize(display, nullptr, nullptr)) {
+                return display;
+            }
+        }
+        auto query_devices = (PFNEGLQUERYDEVICESEXTPROC)
+            eglGetProcAddress("eglQueryDevicesEXT");
+        if(query_devices && hasEGLExtension(client_ext, "EGL_EXT_platform_device")) {
+            EGLint num_devices = 0;
+            if(query_devices(0, nullptr, &num_devices) && num_devices > 0) {
+                std::vector<EGLDeviceEXT> devices(num_devices);
+                query_devices(num_devices, devices.data(), &num_devices);
+                for(EGLint i = 0; i < num_devices; i++) {
+                    EGLDisplay display = get_platform_display(
+                        EGL_PLATFORM_DEVICE_EXT, devices[i], nullptr);
+                    if(display != EGL_NO_DISPLAY &&
+                       eglInitialize(display, nullptr, nullptr)) {
+                        return display;
+                    }
+                }
+            }
+        }
+    }
+
+    EGLDisplay display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if(display != EGL_NO_DISPLAY && eglInitialize(display, nullptr, nullptr)) {
+        return display;
+    }
+    return EGL_NO_DISPLAY;
+}
+
+static void destroyEGLContext() {
+    if(egl_display == EGL_NO_DISPLAY) return;
+
+    eglMakeCurrent(egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if(egl_surface != EGL_NO_SURFACE) {
+        eglDestroySurface(egl_display, egl_surface);
+        egl_surface = EGL_NO_SURFACE;
+    }
+    if(egl_context != EGL_NO_CONTEXT) {
+        eglDestroyContext(egl_display, egl_context);
+        egl_context = EGL_NO_CONTEXT;
+    }
+    eglTerminate(egl_display);
+    egl_display = EGL_NO_DISPLAY;
+}
+
+static bool createEGLContext(uint8_t ver_major, uint8_t ver_minor) {
+    egl_display = openEGLDisplay();
+    if(egl_display == EGL_NO_DISPLAY) {
+        GL_UTIL_LOG("WARNING: No EGL display is available.\n");
+        return false;
+    }
+
+    const EGLint config_attribs[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8,
+        EGL_GREEN_SIZE, 8,
+        EGL_BLUE_SIZE, 8,
+        EGL_ALPHA_SIZE, 8,
+        EGL_DEPTH_SIZE, 24,
+        EGL_NONE
+    };
+    EGLConfig config;
+    EGLint num_config = 0;
+    if(!eglChooseConfig(egl_display, config_attribs, &config, 1, &num_config) ||
+       num_config == 0) {
+        GL_UTIL_LOG("WARNING: No suitable EGL config.\n");
+        destroyEGLContext();
+        return false;
+    }
+
+    if(!eglBindAPI(EGL_OPENGL_API)) {
+        GL_UTIL_LOG("WARNING: EGL does not support desktop OpenGL.\n");
+        destroyEGLContext();
+        return false;
+    }
+
+    const EGLint context_attribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, ver_major,
+        EGL_CONTEXT_MINOR_VERSION, ver_minor,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    egl_context = eglCreateContext(egl_display, config, EGL_NO_CONTEXT, context_attribs);
+    if(egl_context == EGL_NO_CONTEXT) {
+        GL_UTIL_LOG("WARNING: Failed to create EGL context of OpenGL %d.%d.\n",
+                    ver_major, ver_minor);
+        destroyEGLContext();
+        return false;
+    }
+
+    // A surfaceless context is enough since all rendering goes to FBOs, a 1x1 pbuffer
+    // is created only when the display cannot do that.
+    const char* display_ext = eglQueryString(egl_display, EGL_EXTENSIONS);
+    if(!hasEGLExtension(display_ext, "EGL_KHR_surfaceless_context")) {
+        const EGLint pbuffer_attribs[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+        egl_surface = eglCreatePbufferSurface(egl_display, config, pbuffer_attribs);
+        if(egl_surface == EGL_NO_SURFACE) {
+            GL_UTIL_LOG("WARNING: Failed to create EGL pbuffer surface.\n");
+            destroyEGLContext();
+            return false;
+        }
+    }
+
+    if(!eglMakeCurrent(egl_display, egl_surface, egl_surface, egl_context)) {
+        GL_UTIL_LOG("WARNING: Failed to make EGL context current.\n");
+        destroyEGLContext();
+        return false;
+    }
+    return true;
+}
+
+#endif // GL_UTIL_WITH_EGL
+
+/* ----------------------------------------------------------------------------------- */
+/*                                    OSMesa backend                                   */
+/* ----------------------------------------------------------------------------------- */
+#ifdef GL_UTIL_WITH_OSMESA
+
+static OSMesaContext osmesa_context = nullptr;
+/* OSMesa always requires a color buffer, though nothing will be drawn to it. */
+static std::vector<unsigned char> osmesa_buffer(4);
+
+static void destroyOSMesaContext() {
+    if(osmesa_context) {
+        OSMesaDestroyContext(osmesa_context);
+        osmesa_context = nullptr;
+    }
+}
+
+static bool createOSMesaContext(uint8_t ver_major, uint8_t ver_minor) {
+    const int attribs[] = {
+        OSMESA_FORMAT, OSMESA_RGBA,
+        OSMESA_DEPTH_BITS, 24,
+        OSMESA_STENCIL_BITS, 8,
+        OSMESA_PROFILE, OSMESA_CORE_PROFILE,
+        OSMESA_CONTEXT_MAJOR_VERSION, ver_major,
+        OSMESA_CONTEXT_MINOR_VERSION, ver_minor,
+        0
+    };
+    osmesa_context = OSMesaCreateContextAttribs(attribs, nullptr);
+    if(!osmesa_context) {
+        GL_UTIL_LOG("WARNING: Failed to create OSMesa context of OpenGL %d.%d.\n",
+                    ver_major, ver_minor);
+        return false;
+    }
+    if(!OSMesaMakeCurrent(osmesa_context, osmesa_buffer.data(), GL_UNSIGNED_BYTE, 1, 1)) {
+        GL_UTIL_LOG("WARNING: Failed to make OSMesa context current.\n");
+        destroyOSMesaContext();
+        return false;
+    }
+    return true;
+}
+
+#endif // GL_UTIL_WITH_OSMESA
+
+/* ----------------------------------------------------------------------------------- */
+/*                                  Headless interfaces                                */
+/* ----------------------------------------------------------------------------------- */
+
+/**
+ * @brief The backend of the headless context, BACKEND_GLFW means no headless context.
+ */
+static ContextBackend headless_backend = BACKEND_GLFW;
+
+ContextBackend createHeadlessContext(uint8_t ver_major, uint8_t ver_minor,
+                                     ContextBackend backend) {
+    if(headless_backend != BACKEND_GLFW) {
+        return headless_backend;
+    }
+#ifdef GL_UTIL_WITH_EGL
+    if(backend == BACKEND_EGL || backend == BACKEND_HEADLESS) {
+        if(createEGLContext(ver_major, ver_minor)) {
+            headless_backend = BACKEND_EGL;
+            return headless_backend;
+        }
+    }
+#endif
+#ifdef GL_UTIL_WITH_OSMESA
+    if(backend == BACKEND_OSMESA || backend == BACKEND_HEADLESS) {
+        if(createOSMesaContext(ver_major, ver_minor)) {
+            headless_backend = BACKEND_OSMESA;
+            return headless_backend;
+        }
+    }
+#endif
+    (void)ver_major;
+    (void)ver_minor;
+    (void)backend;
+    return BACKEND_GLFW;
+}
+
+bool makeHeadlessContextCurrent() {
+    switch (headless_backend) {
+#ifdef GL_UTIL_WITH_EGL
+    case BACKEND_EGL:
+        return eglMakeCurrent(egl_display, egl_surface, egl_surface, egl_context);
+#endif
+#ifdef GL_UTIL_WITH_OSMESA
+    case BACKEND_OSMESA:
+        return OSMesaMakeCurrent(osmesa_context, osmesa_buffer.data(),
+                                 GL_UNSIGNED_BYTE, 1, 1);
+#endif
+    default:
+        return false;
+    }
+}
+
+void* getHeadlessProcAddress(const char* name) {
+    switch (headless_backend) {
+#ifdef GL_UTIL_WITH_EGL
+    case BACKEND_EGL:
+        return (void*)eglGetProcAddress(name);
+#endif
+#ifdef GL_UTIL_WITH_OSMESA
+    case BACKEND_OSMESA:
+        return (void*)OSMesaGetProcAddress(name);
+#endif
+    default:
+        (void)name;
+        return nullptr;
+    }
+}
+
+void destroyHeadlessContext() {
+    switch (headless_backend) {
+#ifdef GL_UTIL_WITH_EGL
+    case BACKEND_EGL:
+        destroyEGLContext();
+        break;
+#endif
+#ifdef GL_UTIL_WITH_OSMESA
+    case BACKEND_OSMESA:
+        destroyOSMesaContext();
+        break;
+#endif
+    default:
+        break;
+    }
+    headless_backend = BACKEND_GLFW;
+}
+
+GL_UTIL_END
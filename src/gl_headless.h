@@ -0,0 +1,52 @@
+/** -------------------------------------------------------------------------------------
+ *
+ *   				                 OpenGL Utilities
+ *
+ * @file 		gl_headless.h
+ *
+ * @brief 		The internal interfaces of the headless (EGL/OSMesa) context backend.
+ *
+ * @author		Longfei Wang
+ *
+ * @version		1.0.0
+ *
+ * @date		2026/10/16
+ *
+ * @license		MIT
+ *
+ * Copyright (C) 2021-Now Longfei Wang.
+ * ------------------------------------------------------------------------------------*/
+#ifndef GL_UTIL_HEADLESS_H_LF
+#define GL_UTIL_HEADLESS_H_LF
+#include "../include/gl_util/gl_util_ns.h"
+
+GL_UTIL_BEGIN
+
+/**
+ * @brief Create the shared headless context and make it current.
+ *
+ * @param ver_major The major version of OpenGL context.
+ * @param ver_minor The minor version of OpenGL context.
+ * @param backend BACKEND_EGL, BACKEND_OSMESA or BACKEND_HEADLESS.
+ * @return The backend that created the context, or BACKEND_GLFW if failed.
+ */
+ContextBackend createHeadlessContext(uint8_t ver_major, uint8_t ver_minor,
+                                     ContextBackend backend);
+
+/**
+ * @brief Make the shared headless context current on the calling thread.
+ */
+bool makeHeadlessContextCurrent();
+
+/**
+ * @brief Get OpenGL function address from the headless backend.
+ */
+void* getHeadlessProcAddress(const char* name);
+
+/**
+ * @brief Destroy the shared headless context.
+ */
+void destroyHeadlessContext();
+
+GL_UTIL_END
+#endif // GL_UTIL_HEADLESS_H_LF
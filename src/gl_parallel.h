@@ -0,0 +1,66 @@
+/** -------------------------------------------------------------------------------------
+ *
+ *   				                 OpenGL Utilities
+ *
+ * @file 		gl_parallel.h
+ *
+ * @brief 		The internal helper to split a CPU loop to several threads.
+ *
+ * @author		Longfei Wang
+ *
+ * @version		1.0.0
+ *
+ * @date		2026/10/16
+ *
+ * @license		MIT
+ *
+ * Copyright (C) 2021-Now Longfei Wang.
+ * ------------------------------------------------------------------------------------*/
+#ifndef GL_UTIL_PARALLEL_H_LF
+#define GL_UTIL_PARALLEL_H_LF
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+#include "../include/gl_util/gl_util_ns.h"
+
+GL_UTIL_BEGIN
+
+/**
+ * @brief Split [0, n) into contiguous chunks, and run func(begin, end) for each chunk
+ * in its own thread. The calling thread takes the last chunk.
+ *
+ * @param n  The number of items.
+ * @param threads  The number of threads, 0 denotes std::thread::hardware_concurrency().
+ * @param min_chunk  The minimum items of a chunk, to avoid spawning threads for
+ * tiny workloads.
+ * @param func  The function to process items in [begin, end).
+ */
+template <typename Func>
+void parallelFor(size_t n, unsigned threads, size_t min_chunk, Func func) {
+    if(threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    size_t max_threads = std::max<size_t>(1, n / std::max<size_t>(1, min_chunk));
+    threads = (unsigned)std::min<size_t>(threads, max_threads);
+    if(threads <= 1) {
+        func(size_t(0), n);
+        return;
+    }
+
+    size_t chunk = (n + threads - 1) / threads;
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for(unsigned i = 0; i + 1 < threads; i++) {
+        size_t begin = i * chunk;
+        size_t end = std::min(n, begin + chunk);
+        workers.emplace_back(func, begin, end);
+    }
+    func(std::min(n, (threads - 1) * chunk), n);
+    for(auto& worker : workers) {
+        worker.join();
+    }
+}
+
+GL_UTIL_END
+#endif // GL_UTIL_PARALLEL_H_LF
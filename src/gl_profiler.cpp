@@ -0,0 +1,191 @@
+#include "../include/gl_util/gl_profiler.h"
+
+GL_UTIL_BEGIN
+
+/**
+ * @brief The number of query objects generated at once when the pool is empty.
+ */
+static const size_t QUERY_BATCH = 32;
+
+/* ----------------------------------------------------------------------------------- */
+/*                                   Scope implementation                              */
+/* ----------------------------------------------------------------------------------- */
+
+Profiler::Scope::Scope(Profiler& profiler, const char* name)
+    : _profiler(profiler) {
+    _profiler.beginZone(name);
+}
+
+Profiler::Scope::~Scope() {
+    _profiler.endZone();
+}
+
+/* ----------------------------------------------------------------------------------- */
+/*                                 Profiler implementation                             */
+/* ----------------------------------------------------------------------------------- */
+
+Profiler::Profiler(size_t history_size, uint8_t max_latency)
+    : _history_size(history_size > 0 ? history_size : 1)
+    , _max_latency(max_latency > 0 ? max_latency : 1)
+    , _enabled(true)
+    , _in_frame(false)
+    , _frame_index(0) {
+    checkInitStatus();
+}
+
+Profiler::~Profiler() {
+    std::vector<GLuint> queries;
+    queries.swap(_free_queries);
+    for(const auto& frame : _pending) {
+        for(const auto& zone : frame.zones) {
+            queries.push_back(zone.query_begin);
+            queries.push_back(zone.query_end);
+        }
+    }
+    for(const auto& zone : _current.zones) {
+        queries.push_back(zone.query_begin);
+        queries.push_back(zone.query_end);
+    }
+    if(!queries.empty()) {
+        glDeleteQueries(queries.size(), queries.data());
+    }
+}
+
+void Profiler::setEnabled(bool enabled) {
+    // The open frame is ended, rather than left with its queries open.
+    if(!enabled && _in_frame) {
+        endFrame();
+    }
+    _enabled = enabled;
+}
+
+void Profiler::beginFrame() {
+    if(!_enabled) return;
+    if(_in_frame) {
+        GL_UTIL_LOG("WARNING: beginFrame() is called before endFrame()!\n");
+        endFrame();
+    }
+    _in_frame = true;
+    _current.index = _frame_index++;
+    _current.zones.clear();
+    _zone_stack.clear();
+    // The frame itself is recorded as the first zone.
+    beginZone("frame");
+}
+
+void Profiler::endFrame() {
+    if(!_enabled || !_in_frame) return;
+
+    while(!_zone_stack.empty()) {
+        endZone();
+    }
+    _in_frame = false;
+    _pending.push_back(std::move(_current));
+    _current = PendingFrame();
+
+    collect();
+    // Give up the GPU results of the oldest frames, rather than waiting for them.
+    while(_pending.size() > _max_latency) {
+        complete(_pending.front(), false);
+        _pending.pop_front();
+    }
+}
+
+void Profiler::beginZone(const char* name) {
+    if(!_enabled || !_in_frame) return;
+
+    PendingZone zone;
+    zone.name = name;
+    zone.depth = (uint8_t)(_zone_stack.size() > 0 ? _zone_stack.size() - 1 : 0);
+    zone.query_begin = acquireQuery();
+    zone.query_end = acquireQuery();
+    glQueryCounter(zone.query_begin, GL_TIMESTAMP);
+    zone.cpu_begin = Clock::now();
+    zone.cpu_end = zone.cpu_begin;
+
+    _zone_stack.push_back(_current.zones.size());
+    _current.zones.push_back(zone);
+}
+
+void Profiler::endZone() {
+    if(!_enabled || !_in_frame || _zone_stack.empty()) return;
+
+    PendingZone& zone = _current.zones[_zone_stack.back()];
+    _zone_stack.pop_back();
+    glQueryCounter(zone.query_end, GL_TIMESTAMP);
+    zone.cpu_end = Clock::now();
+}
+
+size_t Profiler::historySize() const {
+    return _history.size();
+}
+
+const FrameTiming& Profiler::history(size_t age) const {
+    return _history.at(age);
+}
+
+// --- PRIVATE ---
+GLuint Profiler::acquireQuery() {
+    if(_free_queries.empty()) {
+        _free_queries.resize(QUERY_BATCH);
+        glGenQueries(QUERY_BATCH, _free_queries.data());
+    }
+    GLuint query = _free_queries.back();
+    _free_queries.pop_back();
+    return query;
+}
+
+void Profiler::collect() {
+    while(!_pending.empty()) {
+        PendingFrame& frame = _pending.front();
+        // Queries complete in order, so the frame is done if its last query is.
+        GLint available = GL_FALSE;
+        if(!frame.zones.empty()) {
+            glGetQueryObjectiv(frame.zones.front().query_end,
+                               GL_QUERY_RESULT_AVAILABLE, &available);
+        }
+        if(!available) {
+            break;
+        }
+        complete(frame, true);
+        _pending.pop_front();
+    }
+}
+
+void Profiler::complete(PendingFrame& frame, bool has_gpu) {
+    FrameTiming timing;
+    timing.index = frame.index;
+    timing.cpu_ms = 0;
+    timing.gpu_ms = -1;
+    timing.zones.reserve(frame.zones.size() > 0 ? frame.zones.size() - 1 : 0);
+
+    for(size_t i = 0; i < frame.zones.size(); i++) {
+        const PendingZone& zone = frame.zones[i];
+        double cpu_ms = std::chrono::duration<double, std::milli>(
+            zone.cpu_end - zone.cpu_begin).count();
+        double gpu_ms = -1;
+        if(has_gpu) {
+            GLuint64 begin = 0, end = 0;
+            glGetQueryObjectui64v(zone.query_begin, GL_QUERY_RESULT, &begin);
+            glGetQueryObjectui64v(zone.query_end, GL_QUERY_RESULT, &end);
+            gpu_ms = (end - begin) * 1e-6;
+        }
+        _free_queries.push_back(zone.query_begin);
+        _free_queries.push_back(zone.query_end);
+
+        if(i == 0) {
+            timing.cpu_ms = cpu_ms;
+            timing.gpu_ms = gpu_ms;
+        }
+        else {
+            timing.zones.push_back({zone.name, zone.depth, cpu_ms, gpu_ms});
+        }
+    }
+
+    _history.push_front(std::move(timing));
+    if(_history.size() > _history_size) {
+        _history.pop_back();
+    }
+}
+
+GL_UTIL_END
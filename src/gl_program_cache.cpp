@@ -0,0 +1,209 @@
+#include "../include/gl_util/gl_program_cache.h"
+#include "gl_hash.h"
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+GL_UTIL_BEGIN
+
+/* ----------------------------------------------------------------------------------- */
+/*                               ProgramBinaryCache utility                            */
+/* ----------------------------------------------------------------------------------- */
+
+/** The magic and version at the beginning of each file **/
+static const uint32_t BINARY_MAGIC = 0x42504C47;   // "GLPB"
+static const uint32_t BINARY_VERSION = 1;
+
+/** The header of each file, followed by the binary **/
+struct BinaryHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint32_t format;
+    uint32_t size;
+};
+
+/** The directory of the cache, empty if disabled **/
+static std::mutex directory_mutex;
+static std::string cache_directory;
+
+/**
+ * @brief Get the path of the binary of the key, empty if the cache is disabled.
+ */
+static fs::path binaryPath(uint64_t key) {
+    std::string directory = ProgramBinaryCache::directory();
+    if(directory.empty()) {
+        return fs::path();
+    }
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)key);
+    return fs::path(directory) / name;
+}
+
+/**
+ * @brief Get a temporary path next to the path, unique among threads and processes.
+ */
+static fs::path temporaryPath(const fs::path& path) {
+    static std::atomic<uint32_t> counter(0);
+    static const uint64_t process_id = std::random_device()();
+    uint64_t thread_id = std::hash<std::thread::id>()(std::this_thread::get_id());
+    char suffix[64];
+    snprintf(suffix, sizeof(suffix), ".%llx.%llx.%u.tmp", (unsigned long long)process_id,
+             (unsigned long long)thread_id, counter++);
+    fs::path temporary = path;
+    temporary += suffix;
+    return temporary;
+}
+
+/**
+ * @brief Check whether current context supports any program binary format.
+ */
+static bool isBinarySupported() {
+    GLint num_formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &num_formats);
+    return num_formats > 0;
+}
+
+/* ----------------------------------------------------------------------------------- */
+/*                            ProgramBinaryCache implementation                        */
+/* ----------------------------------------------------------------------------------- */
+
+bool ProgramBinaryCache::setDirectory(const std::string& directory) {
+    std::lock_guard<std::mutex> lock(directory_mutex);
+    cache_directory.clear();
+    if(directory.empty()) {
+        return true;
+    }
+    std::error_code error;
+    fs::create_directories(directory, error);
+    if(!fs::is_directory(directory, error)) {
+        GL_UTIL_LOG("ERROR: Cannot create program cache directory: %s\n",
+                    directory.c_str());
+        return false;
+    }
+    cache_directory = directory;
+    return true;
+}
+
+std::string ProgramBinaryCache::directory() {
+    std::lock_guard<std::mutex> lock(directory_mutex);
+    return cache_directory;
+}
+
+uint64_t ProgramBinaryCache::key(std::initializer_list<std::string_view> sources) {
+    return key(std::vector<std::string_view>(sources));
+}
+
+uint64_t ProgramBinaryCache::key(const std::vector<std::string_view>& sources) {
+    uint64_t hash = HASH_SEED;
+    // Binaries are only valid for the same driver.
+    const GLenum names[] = { GL_VENDOR, GL_RENDERER, GL_VERSION };
+    for(GLenum name : names) {
+        const char* str = (const char*)glGetString(name);
+        hash = hashString(str ? str : "", hash);
+        hash = hashString(std::string_view("\0", 1), hash);
+    }
+    // The length separates the sources, so that moving text between stages changes
+    // the key.
+    for(std::string_view source : sources) {
+        uint64_t length = source.size();
+        hash = hashString(std::string_view((const char*)&length, sizeof(length)), hash);
+        hash = hashString(source, hash);
+    }
+    return hash;
+}
+
+bool ProgramBinaryCache::load(GLuint program, uint64_t key) {
+    fs::path path = binaryPath(key);
+    if(path.empty() || !isBinarySupported()) {
+        return false;
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    if(!file) {
+        return false;
+    }
+    std::error_code error;
+    uintmax_t file_size = fs::file_size(path, error);
+    BinaryHeader header;
+    std::vector<char> binary;
+    // The size is checked against the file before allocating, as it may be corrupted.
+    if(file.read((char*)&header, sizeof(header)) && header.magic == BINARY_MAGIC &&
+       header.version == BINARY_VERSION && header.key == key && !error &&
+       file_size == sizeof(header) + (uintmax_t)header.size) {
+        binary.resize(header.size);
+        file.read(binary.data(), binary.size());
+    }
+    bool is_read = !binary.empty() && file.gcount() == (std::streamsize)binary.size();
+    file.close();
+
+    GLint status = GL_FALSE;
+    if(is_read) {
+        glProgramBinary(program, header.format, binary.data(), binary.size());
+        glGetProgramiv(program, GL_LINK_STATUS, &status);
+    }
+    if(status != GL_TRUE) {
+        // Corrupted, or rejected by the driver, it will be replaced after linking.
+        fs::remove(path, error);
+        return false;
+    }
+    return true;
+}
+
+bool ProgramBinaryCache::store(GLuint program, uint64_t key) {
+    fs::path path = binaryPath(key);
+    if(path.empty()) {
+        return false;
+    }
+
+    GLint status = GL_FALSE, length = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &status);
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if(status != GL_TRUE || length <= 0) {
+        return false;
+    }
+    BinaryHeader header = { BINARY_MAGIC, BINARY_VERSION, key, 0, 0 };
+    std::vector<char> binary(length);
+    GLsizei size = 0;
+    glGetProgramBinary(program, length, &size, &header.format, binary.data());
+    header.size = size;
+
+    // Write a temporary file and rename it, the rename replaces the file atomically.
+    fs::path temporary = temporaryPath(path);
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write((const char*)&header, sizeof(header));
+        file.write(binary.data(), size);
+        file.close();
+        if(!file) {
+            GL_UTIL_LOG("ERROR: Failed to write program binary: %s\n",
+                        temporary.string().c_str());
+            std::error_code error;
+            fs::remove(temporary, error);
+            return false;
+        }
+    }
+    std::error_code error;
+    fs::rename(temporary, path, error);
+    if(error) {
+        fs::remove(temporary, error);
+        return false;
+    }
+    return true;
+}
+
+void ProgramBinaryCache::prepare(GLuint program) {
+    if(directory().empty() || !isBinarySupported()) {
+        return;
+    }
+    glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+GL_UTIL_END
@@ -0,0 +1,105 @@
+#include "../include/gl_util/gl_program_pipeline.h"
+#include "../include/gl_util/gl_shader.h"
+#include "../include/gl_util/gl_state_cache.h"
+#include <utility>
+
+GL_UTIL_BEGIN
+
+ProgramPipeline::ProgramPipeline()
+    : _pipeline(0) {
+    checkInitStatus();
+    glGenProgramPipelines(1, &_pipeline);
+}
+
+ProgramPipeline::ProgramPipeline(ProgramPipeline&& other) noexcept
+    : _pipeline(0) {
+    swap(other);
+}
+
+ProgramPipeline& ProgramPipeline::operator=(ProgramPipeline&& other) noexcept {
+    // The pipeline of this ProgramPipeline is deleted with the temporary.
+    ProgramPipeline moved(std::move(other));
+    swap(moved);
+    return *this;
+}
+
+ProgramPipeline::~ProgramPipeline() {
+    if(_pipeline == 0) return;
+    StateCache::current().deleteProgramPipelines(1, &_pipeline);
+}
+
+bool ProgramPipeline::attach(Shader& shader, GLbitfield stages) {
+    if(!shader.isSeparable()) {
+        GL_UTIL_LOG("ERROR: Only separable programs can be attached to the pipeline!\n");
+        return false;
+    }
+    // The stages of a pending program are only known once it is linked, see apply().
+    if(!shader.isPending()) {
+        stages &= shader.stageBits();
+    }
+    detach(stages);
+    _stages.push_back({ &shader, stages, 0 });
+    apply(_stages.back());
+    return true;
+}
+
+void ProgramPipeline::detach(GLbitfield stages) {
+    glUseProgramStages(_pipeline, stages, 0);
+    for(auto iter = _stages.begin(); iter != _stages.end();) {
+        iter->bits &= ~stages;
+        if(iter->bits == 0) {
+            iter = _stages.erase(iter);
+        }
+        else {
+            ++iter;
+        }
+    }
+}
+
+bool ProgramPipeline::validate() {
+    glValidateProgramPipeline(_pipeline);
+    GLint status = GL_FALSE;
+    glGetProgramPipelineiv(_pipeline, GL_VALIDATE_STATUS, &status);
+    if(status != GL_TRUE) {
+        char info_log[1024] = { 0 };
+        glGetProgramPipelineInfoLog(_pipeline, sizeof(info_log), nullptr, info_log);
+        GL_UTIL_LOG("ERROR: Program pipeline validation error:\n\t%s\n", info_log);
+        return false;
+    }
+    return true;
+}
+
+void ProgramPipeline::bind() {
+    for(Stage& stage : _stages) {
+        stage.shader->update();
+        // A reload links a new program object.
+        if(stage.generation != stage.shader->generation()) {
+            apply(stage);
+        }
+    }
+    // A program in use takes precedence over the bound pipeline.
+    StateCache::current().useProgram(0);
+    StateCache::current().bindProgramPipeline(_pipeline);
+}
+
+GLuint ProgramPipeline::ID() const {
+    return _pipeline;
+}
+
+// --- PRIVATE ---
+void ProgramPipeline::apply(Stage& stage) {
+    stage.generation = stage.shader->generation();
+    if(stage.shader->ID() != 0) {
+        if(!stage.shader->isPending()) {
+            stage.bits &= stage.shader->stageBits();
+        }
+        glUseProgramStages(_pipeline, stage.bits, stage.shader->ID());
+    }
+}
+
+void ProgramPipeline::swap(ProgramPipeline& other) noexcept {
+    std::swap(_pipeline, other._pipeline);
+    std::swap(_stages, other._stages);
+}
+
+GL_UTIL_END
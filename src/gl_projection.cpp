@@ -1,4 +1,9 @@
 #include "../include/gl_util/gl_projection.h"
+#include "gl_depth_kernel.h"
+#include "gl_parallel.h"
+#include <cmath>
+#include <cstdlib>
+#include <vector>
 
 
 GL_UTIL_BEGIN
@@ -32,6 +37,236 @@ float Projection::cvt2RealDepth(float z_buf) const {
     return _B / (_A + 2*z_buf - 1);
 }
 
+/**
+ * @brief The minimum number of depth values processed by a thread.
+ */
+static const size_t MIN_DEPTH_CHUNK = 1 << 14;
+
+/**
+ * @brief The scale to normalize unsigned int depth that holds 'depth_bits' bits.
+ */
+static float depthScale(uint8_t depth_bits) {
+    return float(1.0 / (std::ldexp(1.0, depth_bits) - 1.0));
+}
+
+/**
+ * @brief Check the channels of the color image, which is read as RGB or RGBA.
+ */
+static bool isColorChannelsValid(uint8_t channels) {
+    if(channels != 3 && channels != 4) {
+        GL_UTIL_LOG("ERROR: The color channels should be 3 or 4, but %d is given!\n",
+                    channels);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Check the bits of unsigned int depth, which are shifted by '32 - depth_bits'.
+ */
+static bool isDepthBitsValid(uint8_t depth_bits) {
+    if(depth_bits < 1 || depth_bits > 32) {
+        GL_UTIL_LOG("ERROR: The depth bits should be 1 to 32, but %d is given!\n",
+                    depth_bits);
+        return false;
+    }
+    return true;
+}
+
+void Projection::cvt2RealDepth(const float* in, float* out, size_t n, 
+                               unsigned threads) const {
+    const auto kernel = depthKernels().f32;
+    const float a = _A - 1, b = _B;
+    parallelFor(n, threads, MIN_DEPTH_CHUNK, [&](size_t begin, size_t end) {
+        kernel(in + begin, out + begin, end - begin, a, b, 2.f);
+    });
+}
+
+void Projection::cvt2RealDepth(const uint16_t* in, float* out, size_t n, 
+                               unsigned threads) const {
+    const auto kernel = depthKernels().u16;
+    const float a = _A - 1, b = _B, k = 2.f * depthScale(16);
+    parallelFor(n, threads, MIN_DEPTH_CHUNK, [&](size_t begin, size_t end) {
+        kernel(in + begin, out + begin, end - begin, a, b, k);
+    });
+}
+
+void Projection::cvt2RealDepth(const uint32_t* in, float* out, size_t n, 
+                               uint8_t depth_bits, unsigned threads) const {
+    if(!isDepthBitsValid(depth_bits)) return;
+    const auto kernel = depthKernels().u32;
+    const float a = _A - 1, b = _B, k = 2.f * depthScale(depth_bits);
+    const int shift = 32 - depth_bits;
+    parallelFor(n, threads, MIN_DEPTH_CHUNK, [&](size_t begin, size_t end) {
+        kernel(in + begin, out + begin, end - begin, a, b, k, shift);
+    });
+}
+
+void Projection::cvt2RealDepth(const float* in, size_t in_stride, float* out, 
+                               size_t out_stride, uint16_t width, uint16_t height, 
+                               unsigned threads) const {
+    const auto kernel = depthKernels().f32;
+    const float a = _A - 1, b = _B;
+    size_t min_rows = MIN_DEPTH_CHUNK / (width + 1) + 1;
+    parallelFor(height, threads, min_rows, [&](size_t begin, size_t end) {
+        for(size_t r = begin; r < end; r++) {
+            kernel(in + r * in_stride, out + r * out_stride, width, a, b, 2.f);
+        }
+    });
+}
+
+void Projection::cvt2RealDepth(const uint16_t* in, size_t in_stride, float* out, 
+                               size_t out_stride, uint16_t width, uint16_t height, 
+                               unsigned threads) const {
+    const auto kernel = depthKernels().u16;
+    const float a = _A - 1, b = _B, k = 2.f * depthScale(16);
+    size_t min_rows = MIN_DEPTH_CHUNK / (width + 1) + 1;
+    parallelFor(height, threads, min_rows, [&](size_t begin, size_t end) {
+        for(size_t r = begin; r < end; r++) {
+            kernel(in + r * in_stride, out + r * out_stride, width, a, b, k);
+        }
+    });
+}
+
+void Projection::cvt2RealDepth(const uint32_t* in, size_t in_stride, float* out, 
+                               size_t out_stride, uint16_t width, uint16_t height, 
+                               uint8_t depth_bits, unsigned threads) const {
+    if(!isDepthBitsValid(depth_bits)) return;
+    const auto kernel = depthKernels().u32;
+    const float a = _A - 1, b = _B, k = 2.f * depthScale(depth_bits);
+    const int shift = 32 - depth_bits;
+    size_t min_rows = MIN_DEPTH_CHUNK / (width + 1) + 1;
+    parallelFor(height, threads, min_rows, [&](size_t begin, size_t end) {
+        for(size_t r = begin; r < end; r++) {
+            kernel(in + r * in_stride, out + r * out_stride, width, a, b, k, shift);
+        }
+    });
+}
+
+/**
+ * @brief Unproject the depth buffer row by row.
+ * 
+ * @details 'linearize(in, out, n)' converts a row of depth buffer to real depth into
+ * a per-thread row buffer, which is still in cache when 'project(d, xs, y, r, v)'
+ * back-projects it to the output row v, thus the depth buffer is read only once.
+ */
+template <typename T, typename Linearize, typename Project>
+static void unprojectRows(const T* depth, uint16_t w, uint16_t h, float fxy, float cx, 
+                          float cy, unsigned threads, Linearize linearize, 
+                          Project project) {
+    std::vector<float> xs(w);
+    for(uint16_t u = 0; u < w; u++) {
+        xs[u] = (u - cx) / fxy;
+    }
+    size_t min_rows = MIN_DEPTH_CHUNK / (w + 1) + 1;
+    parallelFor(h, threads, min_rows, [&](size_t begin, size_t end) {
+        std::vector<float> row(w);
+        for(size_t r = begin; r < end; r++) {
+            // The depth buffer is bottom-up, while the cloud is top-down.
+            size_t v = h - 1 - r;
+            linearize(depth + r * w, row.data(), w);
+            project(row.data(), xs.data(), (v - cy) / fxy, r, v);
+        }
+    });
+}
+
+void Projection::unproject(const float* depth, PointXYZ* cloud, unsigned threads) const {
+    const auto& kernels = depthKernels();
+    const float a = _A - 1, b = _B, far_cut = farCut();
+    const uint16_t w = _w;
+    unprojectRows(depth, _w, _h, _fxy, _cx, _cy, threads,
+        [&](const float* in, float* out, size_t n) { 
+            kernels.f32(in, out, n, a, b, 2.f); 
+        },
+        [&](const float* d, const float* xs, float y, size_t, size_t v) {
+            kernels.xyz(d, xs, y, far_cut, cloud + v * w, w);
+        });
+}
+
+void Projection::unproject(const uint16_t* depth, PointXYZ* cloud, 
+                           unsigned threads) const {
+    const auto& kernels = depthKernels();
+    const float a = _A - 1, b = _B, k = 2.f * depthScale(16), far_cut = farCut();
+    const uint16_t w = _w;
+    unprojectRows(depth, _w, _h, _fxy, _cx, _cy, threads,
+        [&](const uint16_t* in, float* out, size_t n) { 
+            kernels.u16(in, out, n, a, b, k); 
+        },
+        [&](const float* d, const float* xs, float y, size_t, size_t v) {
+            kernels.xyz(d, xs, y, far_cut, cloud + v * w, w);
+        });
+}
+
+void Projection::unproject(const uint32_t* depth, PointXYZ* cloud, uint8_t depth_bits, 
+                           unsigned threads) const {
+    if(!isDepthBitsValid(depth_bits)) return;
+    const auto& kernels = depthKernels();
+    const float a = _A - 1, b = _B, k = 2.f * depthScale(depth_bits);
+    const float far_cut = farCut();
+    const int shift = 32 - depth_bits;
+    const uint16_t w = _w;
+    unprojectRows(depth, _w, _h, _fxy, _cx, _cy, threads,
+        [&](const uint32_t* in, float* out, size_t n) { 
+            kernels.u32(in, out, n, a, b, k, shift); 
+        },
+        [&](const float* d, const float* xs, float y, size_t, size_t v) {
+            kernels.xyz(d, xs, y, far_cut, cloud + v * w, w);
+        });
+}
+
+void Projection::unproject(const float* depth, const uint8_t* color, uint8_t channels,
+                           PointXYZRGB* cloud, unsigned threads) const {
+    if(!isColorChannelsValid(channels)) return;
+    const auto& kernels = depthKernels();
+    const float a = _A - 1, b = _B, far_cut = farCut();
+    const uint16_t w = _w;
+    unprojectRows(depth, _w, _h, _fxy, _cx, _cy, threads,
+        [&](const float* in, float* out, size_t n) { 
+            kernels.f32(in, out, n, a, b, 2.f); 
+        },
+        [&](const float* d, const float* xs, float y, size_t r, size_t v) {
+            kernels.xyzrgb(d, xs, y, far_cut, color + r * w * channels, channels, 
+                           cloud + v * w, w);
+        });
+}
+
+void Projection::unproject(const uint16_t* depth, const uint8_t* color, 
+                           uint8_t channels, PointXYZRGB* cloud, 
+                           unsigned threads) const {
+    if(!isColorChannelsValid(channels)) return;
+    const auto& kernels = depthKernels();
+    const float a = _A - 1, b = _B, k = 2.f * depthScale(16), far_cut = farCut();
+    const uint16_t w = _w;
+    unprojectRows(depth, _w, _h, _fxy, _cx, _cy, threads,
+        [&](const uint16_t* in, float* out, size_t n) { 
+            kernels.u16(in, out, n, a, b, k); 
+        },
+        [&](const float* d, const float* xs, float y, size_t r, size_t v) {
+            kernels.xyzrgb(d, xs, y, far_cut, color + r * w * channels, channels, 
+                           cloud + v * w, w);
+        });
+}
+
+void Projection::unproject(const uint32_t* depth, const uint8_t* color, 
+                           uint8_t channels, PointXYZRGB* cloud, uint8_t depth_bits, 
+                           unsigned threads) const {
+    if(!isColorChannelsValid(channels)) return;
+    if(!isDepthBitsValid(depth_bits)) return;
+    const auto& kernels = depthKernels();
+    const float a = _A - 1, b = _B, k = 2.f * depthScale(depth_bits);
+    const float far_cut = farCut();
+    const int shift = 32 - depth_bits;
+    const uint16_t w = _w;
+    unprojectRows(depth, _w, _h, _fxy, _cx, _cy, threads,
+        [&](const uint32_t* in, float* out, size_t n) { 
+            kernels.u32(in, out, n, a, b, k, shift); 
+        },
+        [&](const float* d, const float* xs, float y, size_t r, size_t v) {
+            kernels.xyzrgb(d, xs, y, far_cut, color + r * w * channels, channels, 
+                           cloud + v * w, w);
+        });
+}
+
 Projection Projection::adaptToNED(float ocular_fov, uint16_t screen_w, uint16_t screen_h, 
                                    uint16_t disp_w, uint16_t disp_h) const {
     float im_aspect_ratio = 1.f * _w / _h;
@@ -79,6 +314,11 @@ printf("ned_fxy:%f\n", ned_fxy);
     return Projection(ned_fxy, disp_w, disp_h, _z_near, _z_far);
 }
 
+float Projection::farCut() const {
+    // The far plane in depth buffer is converted to about z_far with rounding error.
+    return _z_far * (1.f - 1e-5f);
+}
+
 void Projection::calcProjection() {
     _projection[0][0] = 2.0 * _fxy / _w;
     _projection[0][2] = 1.0 - 2.0 * _cx / _w;
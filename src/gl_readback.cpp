@@ -0,0 +1,199 @@
+#include "../include/gl_util/gl_readback.h"
+#include "../include/gl_util/gl_state_cache.h"
+#include "../include/gl_util/gl_window.h"
+#include "../include/gl_util/gl_framebuffer.h"
+
+GL_UTIL_BEGIN
+
+/* ----------------------------------------------------------------------------------- */
+/*                                   Readback utility                                  */
+/* ----------------------------------------------------------------------------------- */
+
+/**
+ * @brief Check whether the format is read from the depth or stencil buffer, rather
+ * than a color attachment.
+ */
+static bool isDepthFormat(GLenum format) {
+    return format == GL_DEPTH_COMPONENT || format == GL_DEPTH_STENCIL ||
+           format == GL_STENCIL_INDEX;
+}
+
+/**
+ * @brief Calculate the size of a pixel in bytes.
+ */
+static size_t pixelSize(GLenum format, GLenum type) {
+    if(type == GL_UNSIGNED_INT_24_8) return 4;
+    if(type == GL_FLOAT_32_UNSIGNED_INT_24_8_REV) return 8;
+
+    size_t channels = 1;
+    switch (format) {
+    case GL_RG:   case GL_RG_INTEGER:   channels = 2; break;
+    case GL_RGB:  case GL_BGR:  case GL_RGB_INTEGER:  channels = 3; break;
+    case GL_RGBA: case GL_BGRA: case GL_RGBA_INTEGER: channels = 4; break;
+    default: break;
+    }
+    switch (type) {
+    case GL_UNSIGNED_SHORT: case GL_SHORT: case GL_HALF_FLOAT:
+        return channels * 2;
+    case GL_UNSIGNED_INT: case GL_INT: case GL_FLOAT:
+        return channels * 4;
+    default:
+        return channels;
+    }
+}
+
+/* ----------------------------------------------------------------------------------- */
+/*                              AsyncReadback implementation                           */
+/* ----------------------------------------------------------------------------------- */
+
+AsyncReadback::AsyncReadback(uint16_t width, uint16_t height, GLenum format,
+                             GLenum type, uint8_t depth)
+    : _width(width)
+    , _height(height)
+    , _format(format)
+    , _type(type)
+    , _size(size_t(width) * height * pixelSize(format, type))
+    , _src_fbo(0)
+    , _src_buffer(GL_BACK)
+    , _has_source(false)
+    , _slots(depth > 0 ? depth : 1)
+    , _head(0)
+    , _count(0)
+    , _read_count(0)
+    , _is_mapped(false) {
+    checkInitStatus();
+
+    for(auto& slot : _slots) {
+        glGenBuffers(1, &slot.pbo);
+        StateCache::current().bindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+        glBufferData(GL_PIXEL_PACK_BUFFER, _size, nullptr, GL_STREAM_READ);
+        slot.fence = nullptr;
+        slot.index = 0;
+    }
+    StateCache::current().bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+AsyncReadback::~AsyncReadback() {
+    release();
+    for(auto& slot : _slots) {
+        if(slot.fence) {
+            glDeleteSync(slot.fence);
+        }
+        StateCache::current().deleteBuffers(1, &slot.pbo);
+    }
+}
+
+void AsyncReadback::attach(const Window&) {
+    _src_fbo = 0;
+    _src_buffer = GL_BACK;
+    _has_source = true;
+}
+
+bool AsyncReadback::attach(const FrameBuffer& framebuffer, uint8_t index) {
+    // The ID is 0 before create(), which would read the window instead.
+    if(framebuffer.resolvedID() == 0) {
+        GL_UTIL_LOG("ERROR: The FrameBuffer to read is not created!\n");
+        return false;
+    }
+    if(!isDepthFormat(_format) && index >= framebuffer.colorCount()) {
+        GL_UTIL_LOG("ERROR: The FrameBuffer has no color attachment %d!\n", index);
+        return false;
+    }
+    _src_fbo = framebuffer.resolvedID();
+    _src_buffer = GL_COLOR_ATTACHMENT0 + index;
+    _has_source = true;
+    return true;
+}
+
+bool AsyncReadback::read() {
+    if(!_has_source) {
+        GL_UTIL_LOG("ERROR: No source is attached to AsyncReadback!\n");
+        return false;
+    }
+    // Drop the frame rather than waiting for the consumer.
+    if(_count == _slots.size()) {
+        return false;
+    }
+
+    Slot& slot = _slots[_head];
+    // The read framebuffer and buffer are restored after, as the pack alignment.
+    GLint read_fbo, read_buffer;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &read_fbo);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, _src_fbo);
+    glGetIntegerv(GL_READ_BUFFER, &read_buffer);
+    bool is_depth = isDepthFormat(_format);
+    if(!is_depth) {
+        glReadBuffer(_src_buffer);
+    }
+
+    GLint alignment;
+    glGetIntegerv(GL_PACK_ALIGNMENT, &alignment);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    StateCache::current().bindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+    // With a PBO bound, the last argument is an offset and the call returns at once.
+    glReadPixels(0, 0, _width, _height, _format, _type, nullptr);
+    StateCache::current().bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glPixelStorei(GL_PACK_ALIGNMENT, alignment);
+    if(!is_depth) {
+        glReadBuffer(read_buffer);
+    }
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, read_fbo);
+
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.index = _read_count++;
+
+    _head = (_head + 1) % _slots.size();
+    _count++;
+    return true;
+}
+
+bool AsyncReadback::tryFetch(Frame& frame) {
+    release();
+    if(_count == 0) {
+        return false;
+    }
+
+    size_t tail = (_head + _slots.size() - _count) % _slots.size();
+    Slot& slot = _slots[tail];
+    // Zero timeout, only polls. The flush bit makes sure the fence will be signaled.
+    GLenum status = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    if(status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+        return false;
+    }
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+
+    StateCache::current().bindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+    void* data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, _size, GL_MAP_READ_BIT);
+    StateCache::current().bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    if(!data) {
+        GL_UTIL_LOG("ERROR: Failed to map pixel pack buffer!\n");
+        _count--;
+        return false;
+    }
+    _is_mapped = true;
+
+    frame.data = data;
+    frame.size = _size;
+    frame.width = _width;
+    frame.height = _height;
+    frame.index = slot.index;
+    return true;
+}
+
+void AsyncReadback::release() {
+    if(!_is_mapped) return;
+
+    size_t tail = (_head + _slots.size() - _count) % _slots.size();
+    StateCache::current().bindBuffer(GL_PIXEL_PACK_BUFFER, _slots[tail].pbo);
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    StateCache::current().bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    _is_mapped = false;
+    _count--;
+}
+
+size_t AsyncReadback::pending() const {
+    return _is_mapped ? _count - 1 : _count;
+}
+
+GL_UTIL_END
@@ -0,0 +1,79 @@
+#include "../include/gl_util/gl_render_thread.h"
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+GL_UTIL_BEGIN
+
+RenderThread::RenderThread(GLFWwindow* window)
+    : _window(window)
+    , _is_busy(false)
+    , _should_stop(false) {
+    _thread = std::thread(&RenderThread::run, this);
+}
+
+RenderThread::~RenderThread() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _should_stop = true;
+    }
+    _cv_task.notify_one();
+    if(_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+std::future<void> RenderThread::submit(std::function<void()> task) {
+    std::packaged_task<void()> packaged(std::move(task));
+    std::future<void> future = packaged.get_future();
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _tasks.push_back(std::move(packaged));
+    }
+    _cv_task.notify_one();
+    return future;
+}
+
+void RenderThread::wait() {
+    if(isCurrentThread()) return;
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _cv_idle.wait(lock, [this] { return _tasks.empty() && !_is_busy; });
+}
+
+bool RenderThread::isCurrentThread() const {
+    return std::this_thread::get_id() == _thread.get_id();
+}
+
+// --- PRIVATE ---
+void RenderThread::run() {
+    glfwMakeContextCurrent(_window);
+
+    while(true) {
+        std::packaged_task<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _cv_task.wait(lock, [this] { return _should_stop || !_tasks.empty(); });
+            // Remaining tasks are still run before exiting.
+            if(_tasks.empty()) break;
+            task = std::move(_tasks.front());
+            _tasks.pop_front();
+            _is_busy = true;
+        }
+        task();
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _is_busy = false;
+            if(_tasks.empty()) {
+                _cv_idle.notify_all();
+            }
+        }
+    }
+
+    // Make sure the commands are submitted before other threads use the objects.
+    glFlush();
+    glfwMakeContextCurrent(nullptr);
+    std::lock_guard<std::mutex> lock(_mutex);
+    _cv_idle.notify_all();
+}
+
+GL_UTIL_END
@@ -1,4 +1,13 @@
 #include "../include/gl_util/gl_shader.h"
+#include "../include/gl_util/gl_file_watcher.h"
+#include "../include/gl_util/gl_program_cache.h"
+#include "../include/gl_util/gl_state_cache.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 
 GL_UTIL_BEGIN
 
@@ -35,148 +44,777 @@ void checkShaderCompileErrors(unsigned int shader, std::string type) {
     }
 }
 
+/**
+ * @brief Get the name of the shader type for the error messages.
+ */
+static const char* stageName(GLenum type) {
+    switch (type) {
+    case GL_VERTEX_SHADER:          return "VERTEX";
+    case GL_FRAGMENT_SHADER:        return "FRAGMENT";
+    case GL_GEOMETRY_SHADER:        return "GEOMETRY";
+    case GL_TESS_CONTROL_SHADER:    return "TESS_CONTROL";
+    case GL_TESS_EVALUATION_SHADER: return "TESS_EVALUATION";
+    case GL_COMPUTE_SHADER:         return "COMPUTE";
+    default:                        return "UNKNOWN";
+    }
+}
+
+/**
+ * @brief Get the bit of the shader type for glUseProgramStages().
+ */
+static GLbitfield stageBit(GLenum type) {
+    switch (type) {
+    case GL_VERTEX_SHADER:          return GL_VERTEX_SHADER_BIT;
+    case GL_FRAGMENT_SHADER:        return GL_FRAGMENT_SHADER_BIT;
+    case GL_GEOMETRY_SHADER:        return GL_GEOMETRY_SHADER_BIT;
+    case GL_TESS_CONTROL_SHADER:    return GL_TESS_CONTROL_SHADER_BIT;
+    case GL_TESS_EVALUATION_SHADER: return GL_TESS_EVALUATION_SHADER_BIT;
+    case GL_COMPUTE_SHADER:         return GL_COMPUTE_SHADER_BIT;
+    default:                        return 0;
+    }
+}
+
+/** Not defined by the GL 4.5 loader, same value for the KHR and ARB extensions **/
+#ifndef GL_COMPLETION_STATUS
+#define GL_COMPLETION_STATUS 0x91B1
+#endif
+
+typedef void (APIENTRYP PFNGLMAXSHADERCOMPILERTHREADSPROC)(GLuint count);
+
+/**
+ * @brief Get glMaxShaderCompilerThreadsKHR/ARB if the parallel shader compile
+ * extension is supported, nullptr otherwise.
+ */
+static PFNGLMAXSHADERCOMPILERTHREADSPROC getMaxShaderCompilerThreads() {
+    if(hasExtension("GL_KHR_parallel_shader_compile")) {
+        return (PFNGLMAXSHADERCOMPILERTHREADSPROC)
+            getProcAddress("glMaxShaderCompilerThreadsKHR");
+    }
+    if(hasExtension("GL_ARB_parallel_shader_compile")) {
+        return (PFNGLMAXSHADERCOMPILERTHREADSPROC)
+            getProcAddress("glMaxShaderCompilerThreadsARB");
+    }
+    return nullptr;
+}
+
+/** Whether the parallel shader compile extension is supported, -1 if not checked.
+    The extension is assumed to be the same for all the contexts of the driver. **/
+static std::atomic<int> parallel_compile_support(-1);
+
+/**
+ * @brief Check whether GL_COMPLETION_STATUS can be queried.
+ */
+static bool isParallelCompileSupported() {
+    int support = parallel_compile_support.load();
+    if(support < 0) {
+        support = getMaxShaderCompilerThreads() != nullptr;
+        parallel_compile_support = support;
+    }
+    return support == 1;
+}
+
+/**
+ * @brief Let the driver use as many compiler threads as it wants in current context.
+ */
+static void enableParallelCompile() {
+    if(!isParallelCompileSupported()) return;
+    // Cached per thread, since the function pointer may differ between contexts of
+    // different backends.
+    static thread_local PFNGLMAXSHADERCOMPILERTHREADSPROC max_threads =
+        getMaxShaderCompilerThreads();
+    if(max_threads) {
+        max_threads(0xFFFFFFFF);
+    }
+}
+
+/** The magic number of SPIR-V modules **/
+static constexpr uint32_t SPIRV_MAGIC = 0x07230203;
+
+/**
+ * @brief Get glSpecializeShader of GL 4.6, or glSpecializeShaderARB if GL_ARB_gl_spirv
+ * is supported, nullptr otherwise.
+ */
+static PFNGLSPECIALIZESHADERPROC getSpecializeShader() {
+    if(GLAD_GL_VERSION_4_6 && glSpecializeShader) {
+        return glSpecializeShader;
+    }
+    if(hasExtension("GL_ARB_gl_spirv")) {
+        return (PFNGLSPECIALIZESHADERPROC)getProcAddress("glSpecializeShaderARB");
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Get the specialize function of current context, cached per thread as
+ * enableParallelCompile() does.
+ */
+static PFNGLSPECIALIZESHADERPROC specializeShader() {
+    static thread_local PFNGLSPECIALIZESHADERPROC specialize = getSpecializeShader();
+    return specialize;
+}
+
+/**
+ * @brief Read the SPIR-V module, checking its size and magic number.
+ */
+static bool readSpirv(const std::string& path, std::string& code) {
+    std::ifstream stream(path, std::ios::binary | std::ios::ate);
+    if(!stream) {
+        GL_UTIL_LOG("ERROR: Cannot read the SPIR-V file: %s\n", path.c_str());
+        return false;
+    }
+    code.resize((size_t)stream.tellg());
+    stream.seekg(0);
+    uint32_t magic = 0;
+    if(stream.read(&code[0], code.size()) && code.size() % 4 == 0 && !code.empty()) {
+        memcpy(&magic, code.data(), sizeof(magic));
+    }
+    if(magic != SPIRV_MAGIC) {
+        GL_UTIL_LOG("ERROR: Not a SPIR-V module: %s\n", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Check whether the GL type is a sampler or an image, which is set by integer.
+ */
+static bool isSamplerOrImage(GLenum type) {
+    switch (type) {
+    case GL_SAMPLER_1D:                 case GL_SAMPLER_2D:
+    case GL_SAMPLER_3D:                 case GL_SAMPLER_CUBE:
+    case GL_SAMPLER_1D_SHADOW:          case GL_SAMPLER_2D_SHADOW:
+    case GL_SAMPLER_1D_ARRAY:           case GL_SAMPLER_2D_ARRAY:
+    case GL_SAMPLER_1D_ARRAY_SHADOW:    case GL_SAMPLER_2D_ARRAY_SHADOW:
+    case GL_SAMPLER_2D_MULTISAMPLE:     case GL_SAMPLER_2D_MULTISAMPLE_ARRAY:
+    case GL_SAMPLER_CUBE_SHADOW:        case GL_SAMPLER_BUFFER:
+    case GL_SAMPLER_2D_RECT:            case GL_SAMPLER_2D_RECT_SHADOW:
+    case GL_INT_SAMPLER_2D:             case GL_INT_SAMPLER_3D:
+    case GL_INT_SAMPLER_2D_ARRAY:       case GL_INT_SAMPLER_BUFFER:
+    case GL_UNSIGNED_INT_SAMPLER_2D:    case GL_UNSIGNED_INT_SAMPLER_3D:
+    case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY: case GL_UNSIGNED_INT_SAMPLER_BUFFER:
+    case GL_IMAGE_2D:                   case GL_IMAGE_3D:
+    case GL_IMAGE_2D_ARRAY:             case GL_IMAGE_CUBE:
+    case GL_IMAGE_BUFFER:               case GL_INT_IMAGE_2D:
+    case GL_UNSIGNED_INT_IMAGE_2D:      case GL_UNSIGNED_INT_ATOMIC_COUNTER:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief Check whether a uniform of the GL type can be set as the requested type.
+ */
+static bool isTypeCompatible(GLenum requested, GLenum type) {
+    if(requested == type) return true;
+    return requested == GL_INT && (type == GL_BOOL || isSamplerOrImage(type));
+}
+
+/**
+ * @brief Query the active resources of the program interface.
+ *
+ * @param program  The linked program.
+ * @param interface  GL_UNIFORM, GL_PROGRAM_INPUT, GL_UNIFORM_BLOCK or
+ * GL_SHADER_STORAGE_BLOCK.
+ */
+static std::vector<ShaderResource> queryResources(GLuint program, GLenum interface) {
+    GLint count = 0, max_length = 0;
+    glGetProgramInterfaceiv(program, interface, GL_ACTIVE_RESOURCES, &count);
+    glGetProgramInterfaceiv(program, interface, GL_MAX_NAME_LENGTH, &max_length);
+
+    std::vector<ShaderResource> resources(count);
+    std::vector<char> name(max_length + 1);
+    bool is_block = interface == GL_UNIFORM_BLOCK || interface == GL_SHADER_STORAGE_BLOCK;
+    for(GLint i = 0; i < count; i++) {
+        ShaderResource& resource = resources[i];
+        glGetProgramResourceName(program, interface, i, name.size(), nullptr, name.data());
+        resource.name = name.data();
+        resource.type = 0;
+        resource.location = -1;
+        resource.array_size = 1;
+        resource.block_index = -1;
+        resource.binding = -1;
+        resource.data_size = 0;
+
+        if(is_block) {
+            const GLenum props[] = { GL_BUFFER_BINDING, GL_BUFFER_DATA_SIZE };
+            GLint values[2];
+            glGetProgramResourceiv(program, interface, i, 2, props, 2, nullptr, values);
+            resource.binding = values[0];
+            resource.data_size = values[1];
+        }
+        else {
+            // GL_BLOCK_INDEX is only valid for uniforms.
+            const GLenum props[] = { GL_TYPE, GL_LOCATION, GL_ARRAY_SIZE, GL_BLOCK_INDEX };
+            GLsizei num_props = interface == GL_UNIFORM ? 4 : 3;
+            GLint values[4] = { 0, -1, 1, -1 };
+            glGetProgramResourceiv(program, interface, i, num_props, props, num_props,
+                                   nullptr, values);
+            resource.type = values[0];
+            resource.location = values[1];
+            resource.array_size = values[2];
+            resource.block_index = values[3];
+        }
+    }
+    return resources;
+}
+
+/* ----------------------------------------------------------------------------------- */
+/*                             SpecializationConstant implementation                   */
+/* ----------------------------------------------------------------------------------- */
+
+SpecializationConstant::SpecializationConstant(GLuint id, const std::string& name,
+                                               int value)
+    : id(id)
+    , value((GLuint)value)
+    , name(name)
+    , literal(std::to_string(value)) {
+}
+
+SpecializationConstant::SpecializationConstant(GLuint id, const std::string& name,
+                                               GLuint value)
+    : id(id)
+    , value(value)
+    , name(name)
+    , literal(std::to_string(value) + "u") {
+}
+
+SpecializationConstant::SpecializationConstant(GLuint id, const std::string& name,
+                                               float value)
+    : id(id)
+    , value(0)
+    , name(name) {
+    memcpy(&this->value, &value, sizeof(value));
+    char text[32];
+    snprintf(text, sizeof(text), "%.9g", value);
+    literal = text;
+    // Keep it a float literal in GLSL, e.g. '1.0' rather than '1'.
+    if(literal.find_first_of(".en") == std::string::npos) {
+        literal += ".0";
+    }
+}
+
+SpecializationConstant::SpecializationConstant(GLuint id, const std::string& name,
+                                               bool value)
+    : id(id)
+    , value(value ? 1 : 0)
+    , name(name)
+    , literal(value ? "true" : "false") {
+}
+
 /* ----------------------------------------------------------------------------------- */
 /*                                 Shader implementation                               */
 /* ----------------------------------------------------------------------------------- */
 
 Shader::Shader()
     : _has_created(false)
-    , _id(0) {
+    , _id(0)
+    , _is_separable(false)
+    , _is_pending(false)
+    , _pending_id(0)
+    , _pending_key(0)
+    , _pending_origin(FROM_FILES)
+    , _generation(0)
+    , _origin(FROM_FILES) {
     checkInitStatus();
 }
 
+Shader::Shader(Shader&& other) noexcept
+    : Shader() {
+    swap(other);
+}
+
+Shader& Shader::operator=(Shader&& other) noexcept {
+    // The program of this Shader is deleted with the temporary.
+    Shader moved(std::move(other));
+    swap(moved);
+    // A new generation, so the handles of this Shader resolve the new program.
+    _generation = std::max(_generation, moved._generation) + 1;
+    return *this;
+}
+
 Shader::~Shader() {
+    unwatch();
+    discardPending();
     if(_has_created) {
-        glDeleteProgram(_id);
+        StateCache::current().deleteProgram(_id);
     }
 }
 
-bool Shader::load(const std::string &vs_path, const std::string &fs_path) {
-    if(_has_created){
-        GL_UTIL_LOG("WARNING: Current shader program object will be replaced!\n");
+bool Shader::load(const std::string &vs_path, const std::string &fs_path,
+                  const ShaderDefines &defines) {
+    if(!loadAsync(vs_path, fs_path, defines)) {
+        return false;
+    }
+    return finish();
+}
+
+bool Shader::loadAsync(const std::string &vs_path, const std::string &fs_path,
+                       const ShaderDefines &defines) {
+    return loadStagesAsync({ ShaderStage(GL_VERTEX_SHADER, vs_path),
+                             ShaderStage(GL_FRAGMENT_SHADER, fs_path) }, defines);
+}
+
+bool Shader::loadStages(const std::vector<ShaderStage> &stages,
+                        const ShaderDefines &defines) {
+    if(!loadStagesAsync(stages, defines)) {
+        return false;
+    }
+    return finish();
+}
+
+bool Shader::loadFromSource(std::string_view vs_code, std::string_view fs_code,
+                            const ShaderDefines &defines) {
+    return loadStagesFromSource({ ShaderSource(GL_VERTEX_SHADER, vs_code),
+                                  ShaderSource(GL_FRAGMENT_SHADER, fs_code) }, defines);
+}
+
+bool Shader::loadStagesFromSource(const std::vector<ShaderSource> &sources,
+                                  const ShaderDefines &defines) {
+    if(!loadStagesFromSourceAsync(sources, defines)) {
+        return false;
+    }
+    return finish();
+}
+
+bool Shader::loadStagesFromSourceAsync(const std::vector<ShaderSource> &sources,
+                                       const ShaderDefines &defines) {
+    std::vector<ShaderStage> stages;
+    std::vector<std::string> codes(sources.size());
+    std::vector<std::string> files;
+    bool is_read = !sources.empty();
+    for(size_t i = 0; i < sources.size(); i++) {
+        // Named by the stage in the errors and the source string table.
+        std::string name = std::string("<") + stageName(sources[i].first) + " source>";
+        stages.emplace_back(sources[i].first, name);
+        is_read = ShaderPreprocessor::processSource(sources[i].second, name, defines,
+                                                    codes[i], files) && is_read;
     }
+    if(!is_read) {
+        GL_UTIL_LOG("ERROR: The shader codes are not successfully preprocessed.\n");
+        return false;
+    }
+    return submit(stages, defines, codes, files, FROM_SOURCES);
+}
 
-    /** 1. Retrieve the vertex/fragment source code from filePath **/
-    std::string vertex_code, fragment_code;
-    std::ifstream vs_file, fs_file;
-    // Ensure ifstream objects can throw exceptions:
-    vs_file.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-    fs_file.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-    try {
-        // Open files
-        vs_file.open(vs_path);
-        fs_file.open(fs_path);
-        std::stringstream vs_stream, fs_stream;
-        // Read file's buffer contents into streams
-        vs_stream << vs_file.rdbuf();
-        fs_stream << fs_file.rdbuf();
-        // Close file handlers
-        vs_file.close();
-        fs_file.close();
-        // Convert stream into string
-        vertex_code   = vs_stream.str();
-        fragment_code = fs_stream.str();
-    }
-    catch (std::ifstream::failure& e) {
+bool Shader::loadSpirv(const std::vector<ShaderStage> &spirv_stages,
+                       const SpecializationConstants &constants,
+                       const std::vector<ShaderStage> &glsl_stages) {
+    if(!loadSpirvAsync(spirv_stages, constants, glsl_stages)) {
+        return false;
+    }
+    return finish();
+}
+
+bool Shader::loadSpirvAsync(const std::vector<ShaderStage> &spirv_stages,
+                            const SpecializationConstants &constants,
+                            const std::vector<ShaderStage> &glsl_stages) {
+    if(!isSpirvSupported()) {
+        if(glsl_stages.empty()) {
+            GL_UTIL_LOG("ERROR: SPIR-V is not supported, and no GLSL file is given!\n");
+            return false;
+        }
+        // The constants are defined as macros instead.
+        ShaderDefines defines;
+        for(const SpecializationConstant& constant : constants) {
+            defines.emplace_back(constant.name, constant.literal);
+        }
+        return loadStagesAsync(glsl_stages, defines);
+    }
+
+    std::vector<std::string> codes(spirv_stages.size());
+    std::vector<std::string> files;
+    bool is_read = !spirv_stages.empty();
+    for(size_t i = 0; i < spirv_stages.size(); i++) {
+        is_read = readSpirv(spirv_stages[i].second, codes[i]) && is_read;
+        files.push_back(spirv_stages[i].second);
+    }
+    if(!is_read) {
         if(_has_created) {
             GL_UTIL_LOG("WARNING: Files are not successfully read, "
-                        "keeping use previous vertex and fragment codes.\n");
+                        "keeping use previous shader codes.\n");
+        }
+        return false;
+    }
+    return submit(spirv_stages, ShaderDefines(), codes, files, FROM_SPIRV, constants);
+}
+
+bool Shader::isSpirvSupported() {
+    return specializeShader() != nullptr;
+}
+
+void Shader::setSeparable(bool is_separable) {
+    _is_separable = is_separable;
+}
+
+bool Shader::isSeparable() const {
+    return _is_separable;
+}
+
+GLbitfield Shader::stageBits() const {
+    GLbitfield bits = 0;
+    for(const ShaderStage& stage : _stages) {
+        bits |= stageBit(stage.first);
+    }
+    return bits;
+}
+
+bool Shader::isReady() const {
+    if(!_is_pending || !isParallelCompileSupported()) {
+        return true;
+    }
+    GLint is_completed = GL_FALSE;
+    glGetProgramiv(_pending_id, GL_COMPLETION_STATUS, &is_completed);
+    return is_completed == GL_TRUE;
+}
+
+bool Shader::isPending() const {
+    return _is_pending;
+}
+
+bool Shader::finish() {
+    if(!_is_pending) {
+        return _has_created;
+    }
+
+    GLint status = GL_FALSE;
+    glGetProgramiv(_pending_id, GL_LINK_STATUS, &status);
+    if(status != GL_TRUE) {
+        for(size_t i = 0; i < _pending_shaders.size(); i++) {
+            checkShaderCompileErrors(_pending_shaders[i],
+                                     stageName(_pending_stages[i].first));
+        }
+        checkShaderCompileErrors(_pending_id, "PROGRAM");
+        // The source string numbers in the errors refer to the files.
+        for(size_t i = 0; i < _pending_files.size(); i++) {
+            GL_UTIL_LOG("Source string %zu: %s\n", i, _pending_files[i].c_str());
+        }
+        if(_has_created) {
+            GL_UTIL_LOG("WARNING: Keeping use previous shader program object.\n");
+            // The files of the current program are watched again, if the failed ones
+            // were watched while pending.
+            bool is_rewatched = isWatched() && _pending_files != _files;
+            discardPending();
+            if(is_rewatched) {
+                watch();
+            }
         }
         else {
-            GL_UTIL_LOG("ERROR: Files are not successfully read.\n");
+            // No program to describe, so the failed load is recorded, and its files
+            // can be watched and reloaded once fixed.
+            recordPending();
+            discardPending();
         }
         return false;
     }
-    const char* vs_code = vertex_code.c_str();
-    const char* fs_code = fragment_code.c_str();
-    
-    /** 2. Compile shaders **/
-    unsigned int vertex_shader, fragment_shader;
-    // Create vertex shader
-    vertex_shader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertex_shader, 1, &vs_code, NULL);
-    glCompileShader(vertex_shader);
-    checkShaderCompileErrors(vertex_shader, "VERTEX");
-    // Create fragment Shader
-    fragment_shader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragment_shader, 1, &fs_code, NULL);
-    glCompileShader(fragment_shader);
-    checkShaderCompileErrors(fragment_shader, "FRAGMENT");
-    // Create shader Program and link the vertex and fragment shader to it
-    if(!_has_created) {
-        _id = glCreateProgram();
-    }
-    glAttachShader(_id, vertex_shader);
-    glAttachShader(_id, fragment_shader);
-    glLinkProgram(_id);
-    checkShaderCompileErrors(_id, "PROGRAM");
-    
+    if(!_pending_shaders.empty()) {
+        ProgramBinaryCache::store(_pending_id, _pending_key);
+    }
     // Delete the shaders as they're linked into our program now and no longer necessary
-    glDeleteShader(vertex_shader);
-    glDeleteShader(fragment_shader);
+    for(GLuint shader : _pending_shaders) {
+        glDetachShader(_pending_id, shader);
+        glDeleteShader(shader);
+    }
+    _pending_shaders.clear();
 
+    // Record the load only now, so a failed one keeps describing the current program.
+    recordPending();
+
+    // Swap to the new program.
+    if(_has_created) {
+        StateCache::current().deleteProgram(_id);
+    }
+    _id = _pending_id;
+    _pending_id = 0;
+    _is_pending = false;
     _has_created = true;
+    _generation++;
+    // Locations may change after linking, and the values are reset.
+    _uniform_locations.clear();
+    _uniform_values.clear();
+    applyBlockBindings();
+    reflect();
     return true;
 }
 
+bool Shader::watch(bool enable) {
+    unwatch();
+    if(!enable) {
+        return true;
+    }
+    // The files of the pending load are watched, which is the latest one.
+    const std::vector<std::string>& files = _is_pending ? _pending_files : _files;
+    CodeOrigin origin = _is_pending ? _pending_origin : _origin;
+    if(files.empty() || origin == FROM_SOURCES) {
+        GL_UTIL_LOG("ERROR: No shader file is loaded to watch!\n");
+        return false;
+    }
+    return watchFiles(files);
+}
+
+bool Shader::isWatched() const {
+    return !_watches.empty();
+}
+
+bool Shader::update() {
+    // Reload the changed files, the current program is used until the new one is
+    // ready. The relaxed load keeps the check cheap in the frame loop. The change is
+    // kept until the first load, watched while pending, is finished.
+    if(_is_changed && !_stages.empty() && _is_changed->load(std::memory_order_relaxed) &&
+       _is_changed->exchange(false)) {
+        GL_UTIL_LOG("Shader files are changed, reloading: %s\n",
+                    _stages.front().second.c_str());
+        if(_origin == FROM_SPIRV) {
+            loadSpirvAsync(_stages, _constants);
+        }
+        else {
+            loadStagesAsync(_stages, _defines);
+        }
+    }
+    // Swap to the pending program once it is ready, or wait for it if there is no
+    // program to use meanwhile.
+    if(_is_pending && (!_has_created || isReady())) {
+        finish();
+    }
+    return _has_created;
+}
+
 void Shader::use() { 
+    update();
     if(!isShaderValid()) return;
-    // Activate current shader program.
-    glUseProgram(_id); 
+    // Activate current shader program, skipped if it is already in use.
+    StateCache::current().useProgram(_id);
 }
 
-void Shader::setBool(const std::string &name, bool value) const {     
-    if(!isShaderValid()) return;
-    glUniform1i(glGetUniformLocation(_id, name.c_str()), (int)value); 
+void Shader::setBool(std::string_view name, bool value) const {     
+    setInt(name, (int)value);
 }
 
-void Shader::setInt(const std::string &name, int value) const { 
+void Shader::setInt(std::string_view name, int value) const { 
     if(!isShaderValid()) return;
-    glUniform1i(glGetUniformLocation(_id, name.c_str()), value); 
+    GLint location = uniformLocation(name);
+    if(isUniformChanged(location, &value, 1, sizeof(value))) {
+        glProgramUniform1i(_id, location, value);
+    }
 }
 
-void Shader::setFloat(const std::string &name, float value) const { 
+void Shader::setFloat(std::string_view name, float value) const { 
     if(!isShaderValid()) return;
-    glUniform1f(glGetUniformLocation(_id, name.c_str()), value); 
+    GLint location = uniformLocation(name);
+    if(isUniformChanged(location, &value, 1, sizeof(value))) {
+        glProgramUniform1f(_id, location, value);
+    }
 }
 
-void Shader::setFloat3(const std::string &name, float x, float y, float z) const {
-    if(!isShaderValid()) return;
-    glUniform3f(glGetUniformLocation(_id, name.c_str()), x, y, z); 
+void Shader::setFloat3(std::string_view name, float x, float y, float z) const {
+    setVec3f(name, glm::vec3(x, y, z));
 }
 
-void Shader::setFloat4(const std::string &name, float x, float y, float z, float w) const {
-    if(!isShaderValid()) return;
-    glUniform4f(glGetUniformLocation(_id, name.c_str()), x, y, z, w); 
+void Shader::setFloat4(std::string_view name, float x, float y, float z, float w) const {
+    setVec4f(name, glm::vec4(x, y, z, w));
 }
 
-void Shader::setVec3f(const std::string &name, const glm::vec3 &vec) const {
+void Shader::setVec3f(std::string_view name, const glm::vec3 &vec) const {
     if(!isShaderValid()) return;
-    glUniform3fv(glGetUniformLocation(_id, name.c_str()), 1, glm::value_ptr(vec));
+    GLint location = uniformLocation(name);
+    if(isUniformChanged(location, &vec, 1, sizeof(vec))) {
+        glProgramUniform3fv(_id, location, 1, glm::value_ptr(vec));
+    }
 }
 
-void Shader::setVec3f(const std::string &name, float x, float y, float z) const {
-    if(!isShaderValid()) return;
+void Shader::setVec3f(std::string_view name, float x, float y, float z) const {
+    setVec3f(name, glm::vec3(x, y, z));
+}
+
+void Shader::setVec4f(std::string_view name, const glm::vec4 &vec) const {
+    setVec4fArray(name, &vec, 1);
+}
 
-    glm::vec3 vec(x,y,z);
-    glUniform3fv(glGetUniformLocation(_id, name.c_str()), 1, glm::value_ptr(vec));
+void Shader::setVec4f(std::string_view name, float x, float y, float z, float w) const {
+    setVec4f(name, glm::vec4(x, y, z, w));
 }
 
-void Shader::setVec4f(const std::string &name, const glm::vec4 &vec) const {
+void Shader::setMat4f(std::string_view name, const glm::mat4 &mat) const {
+    setMat4fArray(name, &mat, 1);
+}
+
+void Shader::setVec4fArray(std::string_view name, const glm::vec4 *vecs,
+                           GLsizei count) const {
     if(!isShaderValid()) return;
-    glUniform4fv(glGetUniformLocation(_id, name.c_str()), 1, glm::value_ptr(vec));
+    GLint location = uniformLocation(name);
+    if(isUniformChanged(location, vecs, count, sizeof(glm::vec4))) {
+        glProgramUniform4fv(_id, location, count, glm::value_ptr(vecs[0]));
+    }
 }
 
-void Shader::setVec4f(const std::string &name, float x, float y, float z, float w) const {
+void Shader::setMat4fArray(std::string_view name, const glm::mat4 *mats,
+                           GLsizei count) const {
     if(!isShaderValid()) return;
+    GLint location = uniformLocation(name);
+    if(isUniformChanged(location, mats, count, sizeof(glm::mat4))) {
+        glProgramUniformMatrix4fv(_id, location, count, GL_FALSE,
+                                  glm::value_ptr(mats[0]));
+    }
+}
 
-    glm::vec4 vec(x,y,z,w);
-    glUniform4fv(glGetUniformLocation(_id, name.c_str()), 1, glm::value_ptr(vec));
+void Shader::invalidateUniforms() {
+    _uniform_values.clear();
 }
 
-void Shader::setMat4f(const std::string &name, const glm::mat4 &mat) const {
-    if(!isShaderValid()) return;
-    glUniformMatrix4fv(glGetUniformLocation(_id, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
+uint64_t Shader::uniformIssuedCount() const {
+    return _uniform_values.issuedCount();
+}
+
+uint64_t Shader::uniformSkippedCount() const {
+    return _uniform_values.skippedCount();
+}
+
+void Shader::resetUniformCounters() {
+    _uniform_values.resetCounters();
+}
+
+bool Shader::bindUniformBlock(std::string_view name, GLuint binding) {
+    return bindBlock(GL_UNIFORM_BLOCK, name, binding);
+}
+
+bool Shader::bindStorageBlock(std::string_view name, GLuint binding) {
+    return bindBlock(GL_SHADER_STORAGE_BLOCK, name, binding);
+}
+
+GLuint Shader::ID() const {
+    return _has_created ? _id : 0;
+}
+
+const std::vector<ShaderResource>& Shader::uniforms() const {
+    return _uniforms;
+}
+
+const std::vector<ShaderResource>& Shader::attributes() const {
+    return _attributes;
+}
+
+const std::vector<ShaderResource>& Shader::uniformBlocks() const {
+    return _uniform_blocks;
+}
+
+const std::vector<ShaderResource>& Shader::storageBlocks() const {
+    return _storage_blocks;
+}
+
+const ShaderResource* Shader::findUniform(std::string_view name) const {
+    for(const ShaderResource& uniform : _uniforms) {
+        std::string_view uniform_name = uniform.name;
+        if(uniform_name == name) {
+            return &uniform;
+        }
+        // Arrays are reported as 'name[0]'.
+        if(uniform.array_size > 1 && uniform_name.size() == name.size() + 3 &&
+           uniform_name.substr(0, name.size()) == name &&
+           uniform_name.substr(name.size()) == "[0]") {
+            return &uniform;
+        }
+    }
+    return nullptr;
+}
+
+// --- PRIVATE ---
+bool Shader::loadStagesAsync(const std::vector<ShaderStage> &stages,
+                             const ShaderDefines &defines) {
+    /** Retrieve the source code of the stages from the files, with includes **/
+    std::vector<std::string> codes(stages.size());
+    // All stages share the file list, so each file has a unique source string number.
+    std::vector<std::string> files;
+    bool is_read = !stages.empty();
+    for(size_t i = 0; i < stages.size(); i++) {
+        is_read = ShaderPreprocessor::process(stages[i].second, defines, codes[i], files) &&
+                  is_read;
+    }
+    if(!is_read) {
+        if(_has_created) {
+            GL_UTIL_LOG("WARNING: Files are not successfully read, "
+                        "keeping use previous shader codes.\n");
+        }
+        else {
+            GL_UTIL_LOG("ERROR: Files are not successfully read.\n");
+        }
+        return false;
+    }
+    return submit(stages, defines, codes, files, FROM_FILES);
+}
+
+bool Shader::submit(const std::vector<ShaderStage> &stages, const ShaderDefines &defines,
+                    const std::vector<std::string> &codes, std::vector<std::string> &files,
+                    CodeOrigin origin, const SpecializationConstants &constants) {
+    if(_is_pending) {
+        GL_UTIL_LOG("WARNING: The pending program is discarded!\n");
+        discardPending();
+    }
+    else if(_has_created){
+        GL_UTIL_LOG("WARNING: Current shader program object will be replaced!\n");
+    }
+
+    // Kept aside until the program is linked, see finish().
+    _pending_stages = stages;
+    _pending_constants = constants;
+    _pending_defines = defines;
+    _pending_files.swap(files);
+    _pending_origin = origin;
+
+    // Link into a new program, so the current one stays usable until finish().
+    _pending_id = glCreateProgram();
+    _pending_shaders.clear();
+    _is_pending = true;
+    if(_is_separable) {
+        glProgramParameteri(_pending_id, GL_PROGRAM_SEPARABLE, GL_TRUE);
+    }
+
+    /** 1. Load the cached binary if any, skipping compiling and linking **/
+    // A separable program is linked differently from the same sources.
+    std::vector<std::string_view> sources = {
+        std::string_view(_is_separable ? "separable" : "monolithic") };
+    for(size_t i = 0; i < _pending_stages.size(); i++) {
+        sources.emplace_back((const char*)&_pending_stages[i].first, sizeof(GLenum));
+        sources.emplace_back(codes[i]);
+    }
+    std::vector<GLuint> constant_ids, constant_values;
+    if(origin == FROM_SPIRV) {
+        for(const SpecializationConstant& constant : _pending_constants) {
+            constant_ids.push_back(constant.id);
+            constant_values.push_back(constant.value);
+        }
+        sources.emplace_back((const char*)constant_ids.data(),
+                             constant_ids.size() * sizeof(GLuint));
+        sources.emplace_back((const char*)constant_values.data(),
+                             constant_values.size() * sizeof(GLuint));
+    }
+    _pending_key = ProgramBinaryCache::key(sources);
+    if(ProgramBinaryCache::load(_pending_id, _pending_key)) {
+        return true;
+    }
+
+    /** 2. Compile and link shaders, which run on the driver threads if supported **/
+    enableParallelCompile();
+    for(size_t i = 0; i < _pending_stages.size(); i++) {
+        GLuint shader = glCreateShader(_pending_stages[i].first);
+        if(origin == FROM_SPIRV) {
+            glShaderBinary(1, &shader, GL_SHADER_BINARY_FORMAT_SPIR_V, codes[i].data(),
+                           (GLsizei)codes[i].size());
+            specializeShader()(shader, "main", (GLuint)constant_ids.size(),
+                               constant_ids.data(), constant_values.data());
+        }
+        else {
+            const char* code = codes[i].c_str();
+            glShaderSource(shader, 1, &code, NULL);
+            glCompileShader(shader);
+        }
+        glAttachShader(_pending_id, shader);
+        _pending_shaders.push_back(shader);
+    }
+    // The status is not queried here, since querying it waits for the compiling and
+    // linking.
+    ProgramBinaryCache::prepare(_pending_id);
+    glLinkProgram(_pending_id);
+    return true;
 }
 
 bool Shader::isShaderValid() const {
@@ -186,4 +824,190 @@ bool Shader::isShaderValid() const {
     return false;
 }
 
+void Shader::swap(Shader& other) noexcept {
+    std::swap(_id, other._id);
+    std::swap(_has_created, other._has_created);
+    std::swap(_is_separable, other._is_separable);
+    std::swap(_is_pending, other._is_pending);
+    std::swap(_pending_id, other._pending_id);
+    std::swap(_pending_shaders, other._pending_shaders);
+    std::swap(_pending_key, other._pending_key);
+    std::swap(_pending_origin, other._pending_origin);
+    std::swap(_pending_stages, other._pending_stages);
+    std::swap(_pending_constants, other._pending_constants);
+    std::swap(_pending_defines, other._pending_defines);
+    std::swap(_pending_files, other._pending_files);
+    std::swap(_generation, other._generation);
+    std::swap(_stages, other._stages);
+    std::swap(_origin, other._origin);
+    std::swap(_constants, other._constants);
+    std::swap(_defines, other._defines);
+    std::swap(_files, other._files);
+    // The watch callbacks hold the flag only, so they follow the flag.
+    std::swap(_watches, other._watches);
+    std::swap(_is_changed, other._is_changed);
+    std::swap(_uniform_locations, other._uniform_locations);
+    std::swap(_uniform_values, other._uniform_values);
+    std::swap(_uniforms, other._uniforms);
+    std::swap(_attributes, other._attributes);
+    std::swap(_uniform_blocks, other._uniform_blocks);
+    std::swap(_storage_blocks, other._storage_blocks);
+    std::swap(_block_bindings, other._block_bindings);
+}
+
+GLint Shader::uniformLocation(std::string_view name) const {
+    return _uniform_locations.location(_id, name);
+}
+
+bool Shader::isUniformChanged(GLint location, const void* data, GLsizei count,
+                              size_t size) const {
+    return _uniform_values.update(location, data, count, size);
+}
+
+GLint Shader::resolveUniform(std::string_view name, GLenum type,
+                             GLint& array_size) const {
+    array_size = 0;
+    if(!isShaderValid()) return -1;
+
+    GLint location = uniformLocation(name);
+    std::string key(name);
+    GLuint index = glGetProgramResourceIndex(_id, GL_UNIFORM, key.c_str());
+    // An element like 'lights[2]' is not a resource, use the array instead.
+    GLint element = 0;
+    size_t bracket = key.rfind('[');
+    if(index == GL_INVALID_INDEX && !key.empty() && key.back() == ']' &&
+       bracket != std::string::npos) {
+        element = std::atoi(key.c_str() + bracket + 1);
+        index = glGetProgramResourceIndex(_id, GL_UNIFORM, key.substr(0, bracket).c_str());
+    }
+    if(location < 0 || index == GL_INVALID_INDEX) {
+        GL_UTIL_LOG("ERROR: Shader has no active uniform '%s'!\n", key.c_str());
+        return -1;
+    }
+
+    const GLenum props[] = { GL_TYPE, GL_ARRAY_SIZE };
+    GLint values[2];
+    glGetProgramResourceiv(_id, GL_UNIFORM, index, 2, props, 2, nullptr, values);
+    if(!isTypeCompatible(type, values[0])) {
+        GL_UTIL_LOG("ERROR: The uniform '%s' is of GL type 0x%x, which cannot be set "
+                    "as GL type 0x%x!\n", key.c_str(), values[0], type);
+        return -1;
+    }
+    array_size = std::max(values[1] - element, 1);
+    return location;
+}
+
+bool Shader::watchFiles(const std::vector<std::string> &files) {
+    _is_changed = std::make_shared<std::atomic<bool>>(false);
+    // The callback holds the flag only, the Shader is never touched on the thread.
+    std::shared_ptr<std::atomic<bool>> is_changed = _is_changed;
+    for(const std::string& path : files) {
+        // The included sources in memory never change.
+        if(ShaderPreprocessor::hasSource(path)) continue;
+        uint64_t id = FileWatcher::shared().watch(path, [is_changed](const std::string&) {
+            is_changed->store(true);
+        });
+        if(id == 0) {
+            unwatch();
+            return false;
+        }
+        _watches.push_back(id);
+    }
+    return true;
+}
+
+void Shader::recordPending() {
+    _stages.swap(_pending_stages);
+    _constants.swap(_pending_constants);
+    _defines.swap(_pending_defines);
+    // Watch the new files instead, e.g. an include is added, if watched. The code in
+    // memory has no files to watch.
+    _origin = _pending_origin;
+    if(_origin == FROM_SOURCES) {
+        unwatch();
+        _files.swap(_pending_files);
+    }
+    else if(_pending_files != _files) {
+        _files.swap(_pending_files);
+        if(isWatched()) {
+            unwatch();
+            watchFiles(_files);
+        }
+    }
+    _pending_stages.clear();
+    _pending_constants.clear();
+    _pending_defines.clear();
+    _pending_files.clear();
+}
+
+void Shader::discardPending() {
+    if(!_is_pending) return;
+    for(GLuint shader : _pending_shaders) {
+        glDeleteShader(shader);
+    }
+    _pending_shaders.clear();
+    glDeleteProgram(_pending_id);
+    _pending_id = 0;
+    _is_pending = false;
+    _pending_stages.clear();
+    _pending_constants.clear();
+    _pending_defines.clear();
+    _pending_files.clear();
+}
+
+void Shader::unwatch() {
+    for(uint64_t id : _watches) {
+        FileWatcher::shared().unwatch(id);
+    }
+    _watches.clear();
+    _is_changed.reset();
+}
+
+bool Shader::bindBlock(GLenum interface, std::string_view name, GLuint binding) {
+    auto iter = std::find_if(_block_bindings.begin(), _block_bindings.end(),
+        [&](const BlockBinding& item) {
+            return item.interface == interface && item.name == name;
+        });
+    if(iter == _block_bindings.end()) {
+        _block_bindings.push_back({ interface, std::string(name), binding });
+    }
+    else {
+        iter->binding = binding;
+    }
+    if(!isShaderValid()) return false;
+    bool is_bound = applyBlockBindings();
+    // The binding of the block is reported by reflection.
+    _uniform_blocks = queryResources(_id, GL_UNIFORM_BLOCK);
+    _storage_blocks = queryResources(_id, GL_SHADER_STORAGE_BLOCK);
+    return is_bound;
+}
+
+bool Shader::applyBlockBindings() const {
+    bool is_bound = true;
+    for(const BlockBinding& item : _block_bindings) {
+        GLuint index = glGetProgramResourceIndex(_id, item.interface, item.name.c_str());
+        if(index == GL_INVALID_INDEX) {
+            GL_UTIL_LOG("ERROR: Shader has no active %s block '%s'!\n",
+                        item.interface == GL_UNIFORM_BLOCK ? "uniform" : "storage",
+                        item.name.c_str());
+            is_bound = false;
+            continue;
+        }
+        if(item.interface == GL_UNIFORM_BLOCK) {
+            glUniformBlockBinding(_id, index, item.binding);
+        }
+        else {
+            glShaderStorageBlockBinding(_id, index, item.binding);
+        }
+    }
+    return is_bound;
+}
+
+void Shader::reflect() {
+    _uniforms = queryResources(_id, GL_UNIFORM);
+    _attributes = queryResources(_id, GL_PROGRAM_INPUT);
+    _uniform_blocks = queryResources(_id, GL_UNIFORM_BLOCK);
+    _storage_blocks = queryResources(_id, GL_SHADER_STORAGE_BLOCK);
+}
+
 GL_UTIL_END
\ No newline at end of file
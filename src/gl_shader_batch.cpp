@@ -0,0 +1,61 @@
+#include "../include/gl_util/gl_shader_batch.h"
+#include "../include/gl_util/gl_shader.h"
+
+GL_UTIL_BEGIN
+
+ShaderBatch::ShaderBatch()
+    : _size(0)
+    , _failed_count(0) {
+}
+
+bool ShaderBatch::add(Shader& shader, const std::string& vs_path,
+                      const std::string& fs_path) {
+    _size++;
+    if(!shader.loadAsync(vs_path, fs_path)) {
+        _failed_count++;
+        return false;
+    }
+    _pending.push_back(&shader);
+    return true;
+}
+
+size_t ShaderBatch::poll() {
+    // The ones still pending are kept in submission order, see finish().
+    size_t count = 0;
+    for(Shader* shader : _pending) {
+        if(!shader->isReady()) {
+            _pending[count++] = shader;
+            continue;
+        }
+        if(!shader->finish()) {
+            _failed_count++;
+        }
+    }
+    _pending.resize(count);
+    return _pending.size();
+}
+
+bool ShaderBatch::finish() {
+    // Finish in submission order, the later ones are likely done meanwhile.
+    for(Shader* shader : _pending) {
+        if(!shader->finish()) {
+            _failed_count++;
+        }
+    }
+    _pending.clear();
+    return _failed_count == 0;
+}
+
+size_t ShaderBatch::size() const {
+    return _size;
+}
+
+size_t ShaderBatch::finishedCount() const {
+    return _size - _pending.size();
+}
+
+size_t ShaderBatch::failedCount() const {
+    return _failed_count;
+}
+
+GL_UTIL_END
@@ -0,0 +1,298 @@
+#include "../include/gl_util/gl_shader_preprocessor.h"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <set>
+
+namespace fs = std::filesystem;
+
+GL_UTIL_BEGIN
+
+/* ----------------------------------------------------------------------------------- */
+/*                              ShaderPreprocessor utility                             */
+/* ----------------------------------------------------------------------------------- */
+
+/** The directories to search the included files in, and the sources in memory **/
+static std::mutex include_mutex;
+static std::vector<fs::path> include_directories;
+static std::map<std::string, std::string_view> include_sources;
+
+/** The included files and sources to resolve the includes with **/
+struct IncludeContext {
+    std::vector<fs::path> directories;                  ///< The include directories
+    std::map<std::string, std::string_view> sources;    ///< The sources in memory
+};
+
+/**
+ * @brief Sort the defines by name, the later one of a repeated name is kept.
+ */
+static std::map<std::string, std::string> normalize(const ShaderDefines& defines) {
+    std::map<std::string, std::string> result;
+    for(const auto& define : defines) {
+        result[define.first] = define.second;
+    }
+    return result;
+}
+
+/**
+ * @brief Get the index of the file in the list, appended if not in the list.
+ */
+static size_t fileIndex(std::vector<std::string>& files, const std::string& file) {
+    auto iter = std::find(files.begin(), files.end(), file);
+    if(iter != files.end()) {
+        return iter - files.begin();
+    }
+    files.push_back(file);
+    return files.size() - 1;
+}
+
+/**
+ * @brief Parse the directive of the line, e.g. 'include' of '  # include "a.glsl"'.
+ *
+ * @param line  The line.
+ * @param argument  Output the rest of the line after the directive.
+ * @return The directive, empty if the line is not a directive.
+ */
+static std::string parseDirective(const std::string& line, std::string& argument) {
+    size_t begin = line.find_first_not_of(" \t");
+    if(begin == std::string::npos || line[begin] != '#') {
+        return std::string();
+    }
+    begin = line.find_first_not_of(" \t", begin + 1);
+    if(begin == std::string::npos) {
+        return std::string();
+    }
+    size_t end = begin;
+    while(end < line.size() && (isalnum((unsigned char)line[end]) || line[end] == '_')) {
+        end++;
+    }
+    argument = line.substr(end);
+    return line.substr(begin, end - begin);
+}
+
+/**
+ * @brief Find the included file of the argument like ' "a.glsl"' or ' <a.glsl>'.
+ *
+ * @param is_source  Output whether the include is a source in memory, whose name is
+ * returned.
+ * @return The path of the file, empty if not found.
+ */
+static fs::path resolveInclude(const std::string& argument, const fs::path& directory,
+                               const IncludeContext& context, bool& is_source) {
+    is_source = false;
+    size_t begin = argument.find_first_of("\"<");
+    if(begin == std::string::npos) {
+        return fs::path();
+    }
+    char close = argument[begin] == '"' ? '"' : '>';
+    size_t end = argument.find(close, begin + 1);
+    if(end == std::string::npos) {
+        return fs::path();
+    }
+    std::string name = argument.substr(begin + 1, end - begin - 1);
+
+    std::error_code error;
+    if(close == '"' && !directory.empty() && fs::is_regular_file(directory / name, error)) {
+        return directory / name;
+    }
+    // The sources in memory are found before the files.
+    if(context.sources.count(name)) {
+        is_source = true;
+        return name;
+    }
+    for(const fs::path& include_directory : context.directories) {
+        if(fs::is_regular_file(include_directory / name, error)) {
+            return include_directory / name;
+        }
+    }
+    return fs::path();
+}
+
+/**
+ * @brief Read the whole file into the string at once.
+ */
+static bool readFile(const fs::path& path, std::string& code) {
+    std::ifstream stream(path, std::ios::binary | std::ios::ate);
+    if(!stream) {
+        return false;
+    }
+    code.resize((size_t)stream.tellg());
+    stream.seekg(0);
+    return (bool)stream.read(&code[0], code.size());
+}
+
+/**
+ * @brief Preprocess the code recursively.
+ *
+ * @param code  The code of the file.
+ * @param file  The name of the file in the file list.
+ * @param directory  The directory to search the '#include "file"' in first, empty for
+ * a source in memory.
+ * @param is_root  Whether the file is the stage itself, rather than an include.
+ * @param defines  The '#define' lines to insert after '#version' of the stage.
+ * @param context  The include directories and sources.
+ * @param included  The files included in current stage.
+ */
+static bool processCode(std::string_view code, const std::string& file,
+                        const fs::path& directory, bool is_root, const std::string& defines,
+                        const IncludeContext& context, std::string& source,
+                        std::vector<std::string>& files, std::set<std::string>& included) {
+    size_t index = fileIndex(files, file);
+    included.insert(file);
+
+    bool is_defined = !is_root;
+    if(!is_root) {
+        source += "#line 1 " + std::to_string(index) + "\n";
+    }
+
+    std::string line, argument, text;
+    text.reserve(code.size() + defines.size());
+    int number = 0;
+    bool is_ok = true;
+    for(size_t begin = 0; begin < code.size();) {
+        size_t end = std::min(code.find('\n', begin), code.size());
+        line.assign(code.substr(begin, end - begin));
+        begin = end + 1;
+        number++;
+        std::string directive = parseDirective(line, argument);
+        std::string next_line = "#line " + std::to_string(number + 1) + " " +
+                                std::to_string(index) + "\n";
+        if(directive == "version" && !is_defined) {
+            // The defines are inserted after '#version', which must come first.
+            text += line + "\n" + defines + next_line;
+            is_defined = true;
+        }
+        else if(directive == "include") {
+            bool is_source = false;
+            fs::path include = resolveInclude(argument, directory, context, is_source);
+            if(include.empty()) {
+                GL_UTIL_LOG("ERROR: Cannot find the included file%s in %s(%d)\n",
+                            argument.c_str(), file.c_str(), number);
+                is_ok = false;
+                text += "\n";
+                continue;
+            }
+
+            std::error_code error;
+            std::string include_file = is_source ? include.string() :
+                                       fs::weakly_canonical(include, error).string();
+            if(included.count(include_file)) {
+                text += "\n";
+                continue;
+            }
+            if(is_source) {
+                is_ok = processCode(context.sources.at(include_file), include_file,
+                                    fs::path(), false, defines, context, text, files,
+                                    included) && is_ok;
+            }
+            else {
+                std::string include_code;
+                if(!readFile(include, include_code)) {
+                    GL_UTIL_LOG("ERROR: Cannot read the shader file: %s\n",
+                                include_file.c_str());
+                    fileIndex(files, include_file);
+                    is_ok = false;
+                    text += "\n";
+                    continue;
+                }
+                is_ok = processCode(include_code, include_file, include.parent_path(),
+                                    false, defines, context, text, files, included) && is_ok;
+            }
+            text += next_line;
+        }
+        else {
+            text += line + "\n";
+        }
+    }
+    if(!is_defined) {
+        // No '#version', define the macros at the beginning.
+        source += defines + "#line 1 " + std::to_string(index) + "\n";
+    }
+    source += text;
+    return is_ok;
+}
+
+/**
+ * @brief Preprocess the stage with the current include directories and sources.
+ */
+static bool processStage(std::string_view code, const std::string& file,
+                         const fs::path& directory, const ShaderDefines& defines,
+                         std::string& source, std::vector<std::string>& files) {
+    IncludeContext context;
+    {
+        std::lock_guard<std::mutex> lock(include_mutex);
+        context.directories = include_directories;
+        context.sources = include_sources;
+    }
+    std::string define_lines;
+    for(const auto& define : normalize(defines)) {
+        define_lines += "#define " + define.first + " " + define.second + "\n";
+    }
+
+    source.clear();
+    std::set<std::string> included;
+    return processCode(code, file, directory, true, define_lines, context, source, files,
+                       included);
+}
+
+/* ----------------------------------------------------------------------------------- */
+/*                           ShaderPreprocessor implementation                         */
+/* ----------------------------------------------------------------------------------- */
+
+void ShaderPreprocessor::addIncludeDirectory(const std::string& directory) {
+    std::lock_guard<std::mutex> lock(include_mutex);
+    include_directories.push_back(directory);
+}
+
+void ShaderPreprocessor::clearIncludeDirectories() {
+    std::lock_guard<std::mutex> lock(include_mutex);
+    include_directories.clear();
+}
+
+void ShaderPreprocessor::addSource(const std::string& name, std::string_view code) {
+    std::lock_guard<std::mutex> lock(include_mutex);
+    include_sources[name] = code;
+}
+
+bool ShaderPreprocessor::hasSource(const std::string& name) {
+    std::lock_guard<std::mutex> lock(include_mutex);
+    return include_sources.count(name) > 0;
+}
+
+void ShaderPreprocessor::clearSources() {
+    std::lock_guard<std::mutex> lock(include_mutex);
+    include_sources.clear();
+}
+
+bool ShaderPreprocessor::process(const std::string& path, const ShaderDefines& defines,
+                                 std::string& source, std::vector<std::string>& files) {
+    std::error_code error;
+    std::string file = fs::weakly_canonical(path, error).string();
+    std::string code;
+    if(!readFile(path, code)) {
+        GL_UTIL_LOG("ERROR: Cannot read the shader file: %s\n", path.c_str());
+        fileIndex(files, file);
+        source.clear();
+        return false;
+    }
+    return processStage(code, file, fs::path(path).parent_path(), defines, source, files);
+}
+
+bool ShaderPreprocessor::processSource(std::string_view code, const std::string& name,
+                                       const ShaderDefines& defines, std::string& source,
+                                       std::vector<std::string>& files) {
+    return processStage(code, name, fs::path(), defines, source, files);
+}
+
+std::string ShaderPreprocessor::key(const ShaderDefines& defines) {
+    std::string result;
+    for(const auto& define : normalize(defines)) {
+        result += define.first + "=" + define.second + ";";
+    }
+    return result;
+}
+
+GL_UTIL_END
@@ -0,0 +1,150 @@
+#include "../include/gl_util/gl_shader_registry.h"
+#include "gl_hash.h"
+
+GL_UTIL_BEGIN
+
+/* ----------------------------------------------------------------------------------- */
+/*                               ShaderRegistry utility                                */
+/* ----------------------------------------------------------------------------------- */
+
+/**
+ * @brief Join the stages of a program, each of the shader type, the code size and the
+ * code, so that different stages never give the same sources.
+ */
+template <typename Code>
+static std::string joinStages(const std::vector<std::pair<GLenum, Code>>& stages,
+                              const std::vector<std::string_view>& codes) {
+    std::string sources;
+    for(size_t i = 0; i < stages.size(); i++) {
+        uint64_t size = codes[i].size();
+        sources.append((const char*)&stages[i].first, sizeof(GLenum));
+        sources.append((const char*)&size, sizeof(size));
+        sources.append(codes[i]);
+    }
+    return sources;
+}
+
+/* ----------------------------------------------------------------------------------- */
+/*                            ShaderRegistry implementation                            */
+/* ----------------------------------------------------------------------------------- */
+
+ShaderRegistry& ShaderRegistry::shared() {
+    static ShaderRegistry registry;
+    return registry;
+}
+
+std::shared_ptr<Shader> ShaderRegistry::load(const std::string &vs_path,
+                                             const std::string &fs_path,
+                                             const ShaderDefines &defines) {
+    return loadStages({ ShaderStage(GL_VERTEX_SHADER, vs_path),
+                        ShaderStage(GL_FRAGMENT_SHADER, fs_path) }, defines);
+}
+
+std::shared_ptr<Shader> ShaderRegistry::loadStages(const std::vector<ShaderStage> &stages,
+                                                   const ShaderDefines &defines) {
+    // The preprocessed codes include the defines and the included files.
+    std::vector<std::string> codes(stages.size());
+    std::vector<std::string> files;
+    bool is_read = !stages.empty();
+    for(size_t i = 0; i < stages.size(); i++) {
+        is_read = ShaderPreprocessor::process(stages[i].second, defines, codes[i], files) &&
+                  is_read;
+    }
+    if(!is_read) {
+        GL_UTIL_LOG("ERROR: Files are not successfully read.\n");
+        return nullptr;
+    }
+
+    std::string sources = joinStages(stages, std::vector<std::string_view>(codes.begin(),
+                                                                           codes.end()));
+    uint64_t key = hashString(sources);
+    std::shared_ptr<Shader> shader = find(key, sources);
+    if(shader) {
+        return shader;
+    }
+    // Submitted directly, so the files are not preprocessed again.
+    shader = std::make_shared<Shader>();
+    if(!shader->submit(stages, defines, codes, files, Shader::FROM_FILES) ||
+       !shader->finish()) {
+        return nullptr;
+    }
+    insert(key, std::move(sources), shader);
+    return shader;
+}
+
+std::shared_ptr<Shader> ShaderRegistry::loadFromSource(std::string_view vs_code,
+                                                       std::string_view fs_code,
+                                                       const ShaderDefines &defines) {
+    std::vector<ShaderSource> sources = { ShaderSource(GL_VERTEX_SHADER, vs_code),
+                                          ShaderSource(GL_FRAGMENT_SHADER, fs_code) };
+    std::string code = joinStages(sources, { vs_code, fs_code });
+    code += ShaderPreprocessor::key(defines);
+    uint64_t key = hashString(code);
+    std::shared_ptr<Shader> shader = find(key, code);
+    if(shader) {
+        return shader;
+    }
+    shader = std::make_shared<Shader>();
+    if(!shader->loadStagesFromSource(sources, defines)) {
+        return nullptr;
+    }
+    insert(key, std::move(code), shader);
+    return shader;
+}
+
+size_t ShaderRegistry::size() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    size_t count = 0;
+    for(const auto& item : _shaders) {
+        count += !item.second.shader.expired();
+    }
+    return count;
+}
+
+uint64_t ShaderRegistry::sharedCount() const {
+    return _shared.load();
+}
+
+uint64_t ShaderRegistry::linkedCount() const {
+    return _linked.load();
+}
+
+// --- PRIVATE ---
+ShaderRegistry::ShaderRegistry()
+    : _shared(0)
+    , _linked(0) {
+}
+
+std::shared_ptr<Shader> ShaderRegistry::find(uint64_t key, const std::string& sources) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto iter = _shaders.find(key);
+    // Different sources of the same hash are linked, replacing the entry.
+    if(iter == _shaders.end() || iter->second.sources != sources) {
+        return nullptr;
+    }
+    std::shared_ptr<Shader> shader = iter->second.shader.lock();
+    if(shader) {
+        _shared++;
+    }
+    return shader;
+}
+
+void ShaderRegistry::insert(uint64_t key, std::string sources,
+                            const std::shared_ptr<Shader>& shader) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    // The released programs are removed here, rather than by the handles.
+    for(auto iter = _shaders.begin(); iter != _shaders.end();) {
+        if(iter->second.shader.expired()) {
+            iter = _shaders.erase(iter);
+        }
+        else {
+            ++iter;
+        }
+    }
+    Entry& entry = _shaders[key];
+    entry.sources = std::move(sources);
+    entry.shader = shader;
+    _linked++;
+}
+
+GL_UTIL_END
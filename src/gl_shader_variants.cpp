@@ -0,0 +1,60 @@
+#include "../include/gl_util/gl_shader_variants.h"
+
+GL_UTIL_BEGIN
+
+ShaderVariants::ShaderVariants(const std::string &vs_path, const std::string &fs_path,
+                               const ShaderDefines &defines)
+    : _vs_path(vs_path)
+    , _fs_path(fs_path)
+    , _defines(defines)
+    , _is_watched(false) {
+}
+
+Shader& ShaderVariants::get(const ShaderDefines &defines) {
+    ShaderDefines merged = merge(defines);
+    std::string key = ShaderPreprocessor::key(merged);
+    auto iter = _variants.find(key);
+    if(iter != _variants.end()) {
+        return *iter->second;
+    }
+
+    // Memoized even if failed, so a broken variant is not compiled every frame.
+    std::unique_ptr<Shader>& shader = _variants[key];
+    shader.reset(new Shader());
+    if(shader->loadAsync(_vs_path, _fs_path, merged) && _is_watched) {
+        shader->watch();
+    }
+    return *shader;
+}
+
+bool ShaderVariants::contains(const ShaderDefines &defines) const {
+    return _variants.count(ShaderPreprocessor::key(merge(defines))) > 0;
+}
+
+size_t ShaderVariants::size() const {
+    return _variants.size();
+}
+
+void ShaderVariants::clear() {
+    _variants.clear();
+}
+
+void ShaderVariants::watch(bool enable) {
+    _is_watched = enable;
+    for(auto& item : _variants) {
+        Shader& shader = *item.second;
+        if(shader.isWatched() != enable) {
+            shader.watch(enable);
+        }
+    }
+}
+
+// --- PRIVATE ---
+ShaderDefines ShaderVariants::merge(const ShaderDefines &defines) const {
+    // The later defines override the earlier ones, see ShaderPreprocessor::key().
+    ShaderDefines merged = _defines;
+    merged.insert(merged.end(), defines.begin(), defines.end());
+    return merged;
+}
+
+GL_UTIL_END
@@ -0,0 +1,436 @@
+#include "../include/gl_util/gl_state_cache.h"
+#include <GLFW/glfw3.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+GL_UTIL_BEGIN
+
+/* ----------------------------------------------------------------------------------- */
+/*                                  StateCache utility                                 */
+/* ----------------------------------------------------------------------------------- */
+
+/** The value of a state that is not known by the cache **/
+static const GLuint UNKNOWN = 0xFFFFFFFF;
+
+/** The caches of all the contexts, which are never freed so that the references
+    stay valid **/
+static std::mutex caches_mutex;
+static std::unordered_map<const void*, std::unique_ptr<StateCache>> caches;
+
+/** Increased by each deletion, other caches invalidate themselves when they see it,
+    since a deleted name can be reused while the old object is still bound there **/
+static std::atomic<uint64_t> delete_epoch(0);
+
+/** The cache of the context used last time on this thread **/
+static thread_local const void* last_context = nullptr;
+static thread_local StateCache* last_cache = nullptr;
+
+/** The key of the headless context, since there is no GLFWwindow **/
+static const char headless_context = 0;
+
+/**
+ * @brief Get the handle that identifies current context.
+ */
+static const void* currentContext() {
+    if(backend() != BACKEND_GLFW) {
+        return &headless_context;
+    }
+    return glfwGetCurrentContext();
+}
+
+/**
+ * @brief Get the index of the buffer target in the shadow, -1 if not shadowed.
+ */
+static int bufferIndex(GLenum target) {
+    switch (target) {
+    case GL_ARRAY_BUFFER:           return 0;
+    case GL_ELEMENT_ARRAY_BUFFER:   return 1;
+    case GL_PIXEL_PACK_BUFFER:      return 2;
+    case GL_PIXEL_UNPACK_BUFFER:    return 3;
+    case GL_UNIFORM_BUFFER:         return 4;
+    case GL_SHADER_STORAGE_BUFFER:  return 5;
+    case GL_COPY_READ_BUFFER:       return 6;
+    case GL_COPY_WRITE_BUFFER:      return 7;
+    case GL_DRAW_INDIRECT_BUFFER:   return 8;
+    case GL_DISPATCH_INDIRECT_BUFFER: return 9;
+    default:                        return -1;
+    }
+}
+
+/**
+ * @brief Get the index of the indexed buffer target in the shadow, -1 if not shadowed.
+ */
+static int indexedIndex(GLenum target) {
+    switch (target) {
+    case GL_UNIFORM_BUFFER:         return 0;
+    case GL_SHADER_STORAGE_BUFFER:  return 1;
+    default:                        return -1;
+    }
+}
+
+/**
+ * @brief Get the index of the texture target in the shadow, -1 if not shadowed.
+ */
+static int textureIndex(GLenum target) {
+    switch (target) {
+    case GL_TEXTURE_2D:             return 0;
+    case GL_TEXTURE_2D_ARRAY:       return 1;
+    case GL_TEXTURE_2D_MULTISAMPLE: return 2;
+    case GL_TEXTURE_CUBE_MAP:       return 3;
+    default:                        return -1;
+    }
+}
+
+/**
+ * @brief Get the index of the capability in the shadow, -1 if not shadowed.
+ */
+static int capabilityIndex(GLenum cap) {
+    switch (cap) {
+    case GL_DEPTH_TEST:             return 0;
+    case GL_BLEND:                  return 1;
+    case GL_CULL_FACE:              return 2;
+    case GL_SCISSOR_TEST:           return 3;
+    case GL_STENCIL_TEST:           return 4;
+    case GL_MULTISAMPLE:            return 5;
+    case GL_CLIP_DISTANCE0:         return 6;
+    case GL_FRAMEBUFFER_SRGB:       return 7;
+    case GL_PROGRAM_POINT_SIZE:     return 8;
+    case GL_POLYGON_OFFSET_FILL:    return 9;
+    default:                        return -1;
+    }
+}
+
+/* ----------------------------------------------------------------------------------- */
+/*                               StateCache implementation                             */
+/* ----------------------------------------------------------------------------------- */
+
+template <typename T>
+bool StateCache::update(T& shadow, T value) {
+    if(shadow == value) {
+        _skipped++;
+        return false;
+    }
+    shadow = value;
+    _issued++;
+    return true;
+}
+
+StateCache& StateCache::current() {
+    const void* context = currentContext();
+    if(!last_cache || context != last_context) {
+        std::lock_guard<std::mutex> lock(caches_mutex);
+        std::unique_ptr<StateCache>& cache = caches[context];
+        if(!cache) {
+            cache.reset(new StateCache());
+        }
+        last_context = context;
+        last_cache = cache.get();
+    }
+
+    StateCache& cache = *last_cache;
+    // The relaxed load keeps the check cheap, as the cache is got for each call.
+    if(cache._is_invalidated.load(std::memory_order_relaxed) &&
+       cache._is_invalidated.exchange(false, std::memory_order_acquire)) {
+        cache.invalidate();
+    }
+    uint64_t epoch = delete_epoch.load(std::memory_order_acquire);
+    if(cache._delete_epoch != epoch) {
+        cache.invalidate();
+        cache._delete_epoch = epoch;
+    }
+    return cache;
+}
+
+void StateCache::invalidateContext(const void* context) {
+    std::lock_guard<std::mutex> lock(caches_mutex);
+    // Only marked, since the caches of other threads are used without the lock.
+    for(auto& item : caches) {
+        if(context == nullptr || item.first == context) {
+            item.second->_is_invalidated.store(true, std::memory_order_release);
+        }
+    }
+}
+
+void StateCache::invalidate() {
+    _program = UNKNOWN;
+    _pipeline = UNKNOWN;
+    _vao = UNKNOWN;
+    for(GLuint& buffer : _buffers) {
+        buffer = UNKNOWN;
+    }
+    for(auto& target : _indexed) {
+        for(IndexedBinding& binding : target) {
+            binding.buffer = UNKNOWN;
+        }
+    }
+    _active_unit = UNKNOWN;
+    for(auto& unit : _textures) {
+        for(GLuint& texture : unit) {
+            texture = UNKNOWN;
+        }
+    }
+    for(int8_t& capability : _capabilities) {
+        capability = -1;
+    }
+    _depth_func = UNKNOWN;
+    _depth_mask = -1;
+    _blend_src = UNKNOWN;
+    _blend_dst = UNKNOWN;
+    _blend_equation = UNKNOWN;
+    _has_clear_color = false;
+}
+
+void StateCache::useProgram(GLuint program) {
+    if(update(_program, program)) {
+        glUseProgram(program);
+    }
+}
+
+void StateCache::bindProgramPipeline(GLuint pipeline) {
+    if(update(_pipeline, pipeline)) {
+        glBindProgramPipeline(pipeline);
+    }
+}
+
+void StateCache::bindVertexArray(GLuint vao) {
+    if(update(_vao, vao)) {
+        glBindVertexArray(vao);
+        _buffers[bufferIndex(GL_ELEMENT_ARRAY_BUFFER)] = UNKNOWN;
+    }
+}
+
+void StateCache::bindBuffer(GLenum target, GLuint buffer) {
+    int index = bufferIndex(target);
+    if(index < 0) {
+        _issued++;
+        glBindBuffer(target, buffer);
+    }
+    else if(update(_buffers[index], buffer)) {
+        glBindBuffer(target, buffer);
+    }
+}
+
+void StateCache::bindBufferRange(GLenum target, GLuint index, GLuint buffer,
+                                 GLintptr offset, GLsizeiptr size) {
+    int target_index = indexedIndex(target);
+    if(target_index >= 0 && index < MAX_INDEXED_BINDINGS) {
+        IndexedBinding& binding = _indexed[target_index][index];
+        if(binding.buffer == buffer && binding.offset == offset && binding.size == size) {
+            _skipped++;
+            return;
+        }
+        binding.buffer = buffer;
+        binding.offset = offset;
+        binding.size = size;
+    }
+    _issued++;
+    if(size < 0) {
+        glBindBufferBase(target, index, buffer);
+    }
+    else {
+        glBindBufferRange(target, index, buffer, offset, size);
+    }
+    // Both calls bind the generic binding point as well.
+    int generic = bufferIndex(target);
+    if(generic >= 0) {
+        _buffers[generic] = buffer;
+    }
+}
+
+void StateCache::bindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+    bindBufferRange(target, index, buffer, 0, -1);
+}
+
+void StateCache::activeTexture(GLuint unit) {
+    if(update(_active_unit, unit)) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+    }
+}
+
+void StateCache::bindTexture(GLenum target, GLuint texture) {
+    int index = textureIndex(target);
+    if(index < 0 || _active_unit >= MAX_TEXTURE_UNITS) {
+        _issued++;
+        glBindTexture(target, texture);
+    }
+    else if(update(_textures[_active_unit][index], texture)) {
+        glBindTexture(target, texture);
+    }
+}
+
+void StateCache::bindTextureUnit(GLuint unit, GLenum target, GLuint texture) {
+    // Skip the unit switch as well when the texture is already bound there.
+    int index = textureIndex(target);
+    if(index >= 0 && unit < MAX_TEXTURE_UNITS && _textures[unit][index] == texture) {
+        _skipped++;
+        return;
+    }
+    activeTexture(unit);
+    bindTexture(target, texture);
+}
+
+void StateCache::setCapability(GLenum cap, bool enable) {
+    int index = capabilityIndex(cap);
+    if(index < 0) {
+        _issued++;
+    }
+    else if(!update(_capabilities[index], int8_t(enable))) {
+        return;
+    }
+    if(enable) glEnable(cap);
+    else glDisable(cap);
+}
+
+void StateCache::enable(GLenum cap) {
+    setCapability(cap, true);
+}
+
+void StateCache::disable(GLenum cap) {
+    setCapability(cap, false);
+}
+
+void StateCache::depthFunc(GLenum func) {
+    if(update(_depth_func, func)) {
+        glDepthFunc(func);
+    }
+}
+
+void StateCache::depthMask(GLboolean flag) {
+    if(update(_depth_mask, GLint(flag))) {
+        glDepthMask(flag);
+    }
+}
+
+void StateCache::blendFunc(GLenum src, GLenum dst) {
+    if(_blend_src == src && _blend_dst == dst) {
+        _skipped++;
+        return;
+    }
+    _blend_src = src;
+    _blend_dst = dst;
+    _issued++;
+    glBlendFunc(src, dst);
+}
+
+void StateCache::blendEquation(GLenum mode) {
+    if(update(_blend_equation, mode)) {
+        glBlendEquation(mode);
+    }
+}
+
+void StateCache::clearColor(float R, float G, float B, float A) {
+    if(_has_clear_color && _clear_color[0] == R && _clear_color[1] == G &&
+       _clear_color[2] == B && _clear_color[3] == A) {
+        _skipped++;
+        return;
+    }
+    _clear_color[0] = R;
+    _clear_color[1] = G;
+    _clear_color[2] = B;
+    _clear_color[3] = A;
+    _has_clear_color = true;
+    _issued++;
+    glClearColor(R, G, B, A);
+}
+
+void StateCache::deleteProgram(GLuint program) {
+    glDeleteProgram(program);
+    // A program in use is only flagged for deletion, and stays in use.
+    if(_program == program) {
+        _program = UNKNOWN;
+    }
+    onDelete();
+}
+
+void StateCache::deleteProgramPipelines(GLsizei n, const GLuint* pipelines) {
+    glDeleteProgramPipelines(n, pipelines);
+    for(GLsizei i = 0; i < n; i++) {
+        if(pipelines[i] != 0 && _pipeline == pipelines[i]) {
+            _pipeline = 0;
+        }
+    }
+    onDelete();
+}
+
+void StateCache::deleteVertexArrays(GLsizei n, const GLuint* vaos) {
+    glDeleteVertexArrays(n, vaos);
+    for(GLsizei i = 0; i < n; i++) {
+        if(vaos[i] != 0 && _vao == vaos[i]) {
+            _vao = 0;
+            _buffers[bufferIndex(GL_ELEMENT_ARRAY_BUFFER)] = UNKNOWN;
+        }
+    }
+    onDelete();
+}
+
+void StateCache::deleteBuffers(GLsizei n, const GLuint* buffers) {
+    glDeleteBuffers(n, buffers);
+    // Deleted buffers are unbound from the bindings of current context.
+    for(GLsizei i = 0; i < n; i++) {
+        for(GLuint& buffer : _buffers) {
+            if(buffers[i] != 0 && buffer == buffers[i]) {
+                buffer = 0;
+            }
+        }
+        for(auto& target : _indexed) {
+            for(IndexedBinding& binding : target) {
+                if(buffers[i] != 0 && binding.buffer == buffers[i]) {
+                    binding.buffer = 0;
+                    binding.offset = 0;
+                    binding.size = -1;
+                }
+            }
+        }
+    }
+    onDelete();
+}
+
+void StateCache::deleteTextures(GLsizei n, const GLuint* textures) {
+    glDeleteTextures(n, textures);
+    // Deleted textures are unbound from all the units of current context.
+    for(GLsizei i = 0; i < n; i++) {
+        for(auto& unit : _textures) {
+            for(GLuint& texture : unit) {
+                if(textures[i] != 0 && texture == textures[i]) {
+                    texture = 0;
+                }
+            }
+        }
+    }
+    onDelete();
+}
+
+uint64_t StateCache::issuedCount() const {
+    return _issued;
+}
+
+uint64_t StateCache::skippedCount() const {
+    return _skipped;
+}
+
+void StateCache::resetCounters() {
+    _issued = 0;
+    _skipped = 0;
+}
+
+// --- PRIVATE ---
+StateCache::StateCache()
+    : _delete_epoch(delete_epoch.load())
+    , _is_invalidated(false)
+    , _issued(0)
+    , _skipped(0) {
+    invalidate();
+}
+
+void StateCache::onDelete() {
+    uint64_t epoch = ++delete_epoch;
+    // Deletions by other contexts since last time have not been handled yet.
+    if(epoch != _delete_epoch + 1) {
+        invalidate();
+    }
+    _delete_epoch = epoch;
+}
+
+GL_UTIL_END
@@ -0,0 +1,239 @@
+#include "../include/gl_util/gl_stereo.h"
+#include "../include/gl_util/gl_state_cache.h"
+#include "../include/gl_util/gl_shader.h"
+#include <glm/gtc/matrix_transform.hpp>
+
+GL_UTIL_BEGIN
+
+/* ----------------------------------------------------------------------------------- */
+/*                              StereoProjection implementation                        */
+/* ----------------------------------------------------------------------------------- */
+
+StereoProjection::StereoProjection(const Projection& left, const Projection& right,
+                                   float baseline)
+    : _projections{ left, right } {
+    // The eye at -baseline/2 sees the scene shifted by +baseline/2, and vice versa.
+    _eye_transforms[0] = glm::translate(glm::mat4(1.f), glm::vec3(baseline / 2, 0, 0));
+    _eye_transforms[1] = glm::translate(glm::mat4(1.f), glm::vec3(-baseline / 2, 0, 0));
+}
+
+StereoProjection::StereoProjection(const Projection& projection, float baseline)
+    : StereoProjection(projection, projection, baseline) {
+}
+
+void StereoProjection::setEyeTransforms(const glm::mat4& left, const glm::mat4& right) {
+    _eye_transforms[0] = left;
+    _eye_transforms[1] = right;
+}
+
+const Projection& StereoProjection::projection(uint8_t eye) const {
+    return _projections[eye & 1];
+}
+
+glm::mat4 StereoProjection::viewProjection(uint8_t eye, const glm::mat4& view) const {
+    eye &= 1;
+    return _projections[eye].mat4() * _eye_transforms[eye] * view;
+}
+
+StereoProjection StereoProjection::adaptToNED(float ocular_fov, uint16_t screen_w,
+                                              uint16_t screen_h, uint16_t disp_w,
+                                              uint16_t disp_h) const {
+    StereoProjection stereo(
+        _projections[0].adaptToNED(ocular_fov, screen_w, screen_h, disp_w, disp_h),
+        _projections[1].adaptToNED(ocular_fov, screen_w, screen_h, disp_w, disp_h), 0);
+    stereo.setEyeTransforms(_eye_transforms[0], _eye_transforms[1]);
+    return stereo;
+}
+
+/* ----------------------------------------------------------------------------------- */
+/*                               StereoRenderer implementation                         */
+/* ----------------------------------------------------------------------------------- */
+
+StereoRenderer::StereoRenderer(uint16_t eye_width, uint16_t eye_height, StereoMode mode)
+    : _eye_width(eye_width)
+    , _eye_height(eye_height)
+    , _mode(mode)
+    , _is_amd_ext(false)
+    , _fbo(0)
+    , _eye_fbos{ 0, 0 }
+    , _color(0)
+    , _depth(0)
+    , _viewport{ 0, 0, 0, 0 } {
+    checkInitStatus();
+
+    if(_mode != STEREO_INSTANCED && !hasExtension("GL_ARB_shader_viewport_layer_array")) {
+        _is_amd_ext = true;
+        const char* amd_ext = _mode == STEREO_LAYERED ? "GL_AMD_vertex_shader_layer"
+                                                      : "GL_AMD_vertex_shader_viewport_index";
+        if(!hasExtension(amd_ext)) {
+            GL_UTIL_LOG("WARNING: writing %s in vertex shader is not supported, "
+                        "fall back to instanced stereo.\n",
+                        _mode == STEREO_LAYERED ? "gl_Layer" : "gl_ViewportIndex");
+            _mode = STEREO_INSTANCED;
+            _is_amd_ext = false;
+        }
+    }
+    createTarget();
+}
+
+StereoRenderer::~StereoRenderer() {
+    glDeleteFramebuffers(1, &_fbo);
+    glDeleteFramebuffers(2, _eye_fbos);
+    StateCache& cache = StateCache::current();
+    cache.deleteTextures(1, &_color);
+    cache.deleteTextures(1, &_depth);
+}
+
+StereoMode StereoRenderer::mode() const {
+    return _mode;
+}
+
+std::string StereoRenderer::vertexShaderHeader() const {
+    std::string header;
+    switch (_mode) {
+    case STEREO_LAYERED:
+        header += _is_amd_ext ? "#extension GL_AMD_vertex_shader_layer : require\n"
+                              : "#extension GL_ARB_shader_viewport_layer_array : require\n";
+        header += "#define STEREO_MODE 0\n";
+        break;
+    case STEREO_VIEWPORT_ARRAY:
+        header += _is_amd_ext ? "#extension GL_AMD_vertex_shader_viewport_index : require\n"
+                              : "#extension GL_ARB_shader_viewport_layer_array : require\n";
+        header += "#define STEREO_MODE 1\n";
+        break;
+    case STEREO_INSTANCED:
+        header += "#define STEREO_MODE 2\n";
+        break;
+    }
+    header +=
+        "uniform mat4 stereo_vp[2];\n"
+        "vec4 stereoPosition(vec4 world_pos) {\n"
+        "    int eye = gl_InstanceID & 1;\n"
+        "    vec4 pos = stereo_vp[eye] * world_pos;\n"
+        "#if STEREO_MODE == 0\n"
+        "    gl_Layer = eye;\n"
+        "#elif STEREO_MODE == 1\n"
+        "    gl_ViewportIndex = eye;\n"
+        "#else\n"
+        "    // Keep each eye in its own half after squeezing it side by side.\n"
+        "    gl_ClipDistance[0] = eye == 0 ? pos.w - pos.x : pos.w + pos.x;\n"
+        "    pos.x = pos.x * 0.5 + (eye == 0 ? -0.5 : 0.5) * pos.w;\n"
+        "#endif\n"
+        "    return pos;\n"
+        "}\n";
+    return header;
+}
+
+void StereoRenderer::begin(Shader& shader, const StereoProjection& projection,
+                           const glm::mat4& view) {
+    glGetIntegerv(GL_VIEWPORT, _viewport);
+    glBindFramebuffer(GL_FRAMEBUFFER, _fbo);
+
+    switch (_mode) {
+    case STEREO_LAYERED:
+        glViewport(0, 0, _eye_width, _eye_height);
+        break;
+    case STEREO_VIEWPORT_ARRAY:
+        glViewportIndexedf(0, 0, 0, _eye_width, _eye_height);
+        glViewportIndexedf(1, _eye_width, 0, _eye_width, _eye_height);
+        break;
+    case STEREO_INSTANCED:
+        glViewport(0, 0, 2 * _eye_width, _eye_height);
+        StateCache::current().enable(GL_CLIP_DISTANCE0);
+        break;
+    }
+    // Clearing of layered attachments clears all the layers.
+    StateCache::current().clearColor(0.f, 0.f, 0.f, 1.f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    shader.use();
+    shader.setMat4f("stereo_vp[0]", projection.viewProjection(0, view));
+    shader.setMat4f("stereo_vp[1]", projection.viewProjection(1, view));
+}
+
+void StereoRenderer::drawArrays(GLenum mode, GLint first, GLsizei count) {
+    glDrawArraysInstanced(mode, first, count, 2);
+}
+
+void StereoRenderer::drawElements(GLenum mode, GLsizei count, GLenum type,
+                                  const void* indices) {
+    glDrawElementsInstanced(mode, count, type, indices, 2);
+}
+
+void StereoRenderer::end() {
+    if(_mode == STEREO_INSTANCED) {
+        StateCache::current().disable(GL_CLIP_DISTANCE0);
+    }
+    // glViewport() sets all the viewports of the array.
+    glViewport(_viewport[0], _viewport[1], _viewport[2], _viewport[3]);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void StereoRenderer::blitEye(uint8_t eye, GLuint dst_fbo, uint16_t dst_width,
+                             uint16_t dst_height) {
+    eye &= 1;
+    GLint src_x = 0;
+    if(_mode == STEREO_LAYERED) {
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, _eye_fbos[eye]);
+    }
+    else {
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, _fbo);
+        src_x = eye * _eye_width;
+    }
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, dst_fbo);
+    glBlitFramebuffer(src_x, 0, src_x + _eye_width, _eye_height,
+                      0, 0, dst_width, dst_height, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+GLuint StereoRenderer::colorTexture() const {
+    return _color;
+}
+
+// --- PRIVATE ---
+void StereoRenderer::createTarget() {
+    glGenFramebuffers(1, &_fbo);
+    glGenTextures(1, &_color);
+    glGenTextures(1, &_depth);
+    StateCache& cache = StateCache::current();
+
+    GLenum target = GL_TEXTURE_2D;
+    if(_mode == STEREO_LAYERED) {
+        target = GL_TEXTURE_2D_ARRAY;
+        cache.bindTexture(target, _color);
+        glTexStorage3D(target, 1, GL_RGBA8, _eye_width, _eye_height, 2);
+        cache.bindTexture(target, _depth);
+        glTexStorage3D(target, 1, GL_DEPTH_COMPONENT24, _eye_width, _eye_height, 2);
+    }
+    else {
+        cache.bindTexture(target, _color);
+        glTexStorage2D(target, 1, GL_RGBA8, 2 * _eye_width, _eye_height);
+        cache.bindTexture(target, _depth);
+        glTexStorage2D(target, 1, GL_DEPTH_COMPONENT24, 2 * _eye_width, _eye_height);
+    }
+    cache.bindTexture(target, _color);
+    glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(target, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    cache.bindTexture(target, 0);
+
+    // glFramebufferTexture() attaches all the layers, making the framebuffer layered.
+    glBindFramebuffer(GL_FRAMEBUFFER, _fbo);
+    glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, _color, 0);
+    glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, _depth, 0);
+    if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        GL_UTIL_LOG("ERROR: the stereo framebuffer is not complete.\n");
+    }
+
+    if(_mode == STEREO_LAYERED) {
+        glGenFramebuffers(2, _eye_fbos);
+        for(GLint eye = 0; eye < 2; eye++) {
+            glBindFramebuffer(GL_FRAMEBUFFER, _eye_fbos[eye]);
+            glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, _color, 0, eye);
+        }
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+GL_UTIL_END
@@ -0,0 +1,114 @@
+#include "../include/gl_util/gl_storage_buffer.h"
+#include "../include/gl_util/gl_state_cache.h"
+#include <utility>
+
+GL_UTIL_BEGIN
+
+StorageBuffer::StorageBuffer(size_t size, const void* data, GLbitfield flags)
+    : _buffer(0)
+    , _size(size)
+    , _is_mapped(false) {
+    checkInitStatus();
+
+    glGenBuffers(1, &_buffer);
+    StateCache::current().bindBuffer(GL_SHADER_STORAGE_BUFFER, _buffer);
+    // Zero-sized storage is not allowed.
+    glBufferStorage(GL_SHADER_STORAGE_BUFFER, size > 0 ? size : 4, data, flags);
+}
+
+StorageBuffer::StorageBuffer(StorageBuffer&& other) noexcept
+    : _buffer(0)
+    , _size(0)
+    , _is_mapped(false) {
+    swap(other);
+}
+
+StorageBuffer& StorageBuffer::operator=(StorageBuffer&& other) noexcept {
+    // The buffer of this StorageBuffer is deleted with the temporary.
+    StorageBuffer moved(std::move(other));
+    swap(moved);
+    return *this;
+}
+
+StorageBuffer::~StorageBuffer() {
+    if(_buffer == 0) return;
+    unmap();
+    StateCache::current().deleteBuffers(1, &_buffer);
+}
+
+bool StorageBuffer::uploadBytes(const void* data, size_t offset, size_t size) {
+    if(!isInRange(offset, size)) return false;
+    StateCache::current().bindBuffer(GL_SHADER_STORAGE_BUFFER, _buffer);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, offset, size, data);
+    return true;
+}
+
+bool StorageBuffer::downloadBytes(void* data, size_t offset, size_t size) const {
+    if(!isInRange(offset, size)) return false;
+    StateCache::current().bindBuffer(GL_SHADER_STORAGE_BUFFER, _buffer);
+    glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, offset, size, data);
+    return true;
+}
+
+void StorageBuffer::clear() {
+    StateCache::current().bindBuffer(GL_SHADER_STORAGE_BUFFER, _buffer);
+    glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R8UI, GL_RED_INTEGER,
+                      GL_UNSIGNED_BYTE, nullptr);
+}
+
+void* StorageBuffer::mapBytes(size_t offset, size_t size, GLbitfield access) {
+    if(!isInRange(offset, size)) return nullptr;
+    if(_is_mapped) {
+        GL_UTIL_LOG("WARNING: The storage buffer is mapped again!\n");
+        unmap();
+    }
+    StateCache::current().bindBuffer(GL_SHADER_STORAGE_BUFFER, _buffer);
+    void* data = glMapBufferRange(GL_SHADER_STORAGE_BUFFER, offset, size, access);
+    _is_mapped = data != nullptr;
+    if(!data) {
+        GL_UTIL_LOG("ERROR: Failed to map the storage buffer!\n");
+    }
+    return data;
+}
+
+void StorageBuffer::unmap() {
+    if(!_is_mapped) return;
+    StateCache::current().bindBuffer(GL_SHADER_STORAGE_BUFFER, _buffer);
+    glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
+    _is_mapped = false;
+}
+
+void StorageBuffer::bind(GLuint binding) const {
+    StateCache::current().bindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, _buffer);
+}
+
+void StorageBuffer::bindBytes(GLuint binding, size_t offset, size_t size) const {
+    if(!isInRange(offset, size)) return;
+    StateCache::current().bindBufferRange(GL_SHADER_STORAGE_BUFFER, binding, _buffer,
+                                          offset, size);
+}
+
+size_t StorageBuffer::bytes() const {
+    return _size;
+}
+
+GLuint StorageBuffer::ID() const {
+    return _buffer;
+}
+
+// --- PRIVATE ---
+bool StorageBuffer::isInRange(size_t offset, size_t size) const {
+    if(offset <= _size && size <= _size - offset) return true;
+
+    GL_UTIL_LOG("ERROR: The range [%zu, %zu) exceeds the storage buffer of %zu bytes!\n",
+                offset, offset + size, _size);
+    return false;
+}
+
+void StorageBuffer::swap(StorageBuffer& other) noexcept {
+    std::swap(_buffer, other._buffer);
+    std::swap(_size, other._size);
+    std::swap(_is_mapped, other._is_mapped);
+}
+
+GL_UTIL_END
@@ -1,15 +1,34 @@
 #include "../include/gl_util/gl_texture.h"
+#include "../include/gl_util/gl_state_cache.h"
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
+#include <utility>
 
 GL_UTIL_BEGIN
 
 Texture2D::Texture2D(unsigned char texture_id)
     : _texture_id(texture_id)
+    , _texture(0)
     , _has_texture(false) {
     checkInitStatus();
 }
 
+Texture2D::Texture2D(Texture2D&& other) noexcept
+    : Texture2D() {
+    swap(other);
+}
+
+Texture2D& Texture2D::operator=(Texture2D&& other) noexcept {
+    // The texture of this Texture2D is deleted with the temporary.
+    Texture2D moved(std::move(other));
+    swap(moved);
+    return *this;
+}
+
+Texture2D::~Texture2D() {
+    release();
+}
+
 bool Texture2D::loadImage(const std::string& texture_path, GLint st_warp, GLint min_filter, GLint mag_filter) {
     if(_has_texture){
         GL_UTIL_LOG("WARNING: Current shader program object will be replaced!\n");
@@ -17,7 +36,7 @@ bool Texture2D::loadImage(const std::string& texture_path, GLint st_warp, GLint
     }
 
     glGenTextures(1, &_texture);
-    glBindTexture(GL_TEXTURE_2D, _texture);
+    StateCache::current().bindTexture(GL_TEXTURE_2D, _texture);
     // Set the texture wrapping parameters
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, st_warp);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, st_warp);
@@ -42,6 +61,9 @@ bool Texture2D::loadImage(const std::string& texture_path, GLint st_warp, GLint
     }
     else {
         GL_UTIL_LOG("Failed to load texture: %s\n", texture_path.c_str());
+        // Not owned until loaded, so delete it here.
+        StateCache::current().deleteTextures(1, &_texture);
+        _texture = 0;
         return false;
     }
     stbi_image_free(data);
@@ -51,21 +73,11 @@ bool Texture2D::loadImage(const std::string& texture_path, GLint st_warp, GLint
 }
 
 void Texture2D::bind() {
-    switch (_texture_id) {
-    case 0:  glActiveTexture(GL_TEXTURE0);  break;
-    case 1:  glActiveTexture(GL_TEXTURE1);  break;
-    case 2:  glActiveTexture(GL_TEXTURE2);  break;
-    case 3:  glActiveTexture(GL_TEXTURE3);  break;
-    case 4:  glActiveTexture(GL_TEXTURE4);  break;
-    case 5:  glActiveTexture(GL_TEXTURE5);  break;
-    case 6:  glActiveTexture(GL_TEXTURE6);  break;
-    case 7:  glActiveTexture(GL_TEXTURE7);  break;
-    case 8:  glActiveTexture(GL_TEXTURE8);  break;
-    default:
+    if(_texture_id > 8) {
         GL_UTIL_LOG("Current version only support 8 texture.\n");
         return;
     }
-    glBindTexture(GL_TEXTURE_2D, _texture);
+    StateCache::current().bindTextureUnit(_texture_id, GL_TEXTURE_2D, _texture);
 }
 
 unsigned char Texture2D::ID() const {
@@ -73,8 +85,17 @@ unsigned char Texture2D::ID() const {
 }
 
 void Texture2D::release() {
+    if(!_has_texture) return;
     _has_texture = false;
-    glDeleteTextures(1, &_texture);
+    StateCache::current().deleteTextures(1, &_texture);
+    _texture = 0;
+}
+
+// --- PRIVATE ---
+void Texture2D::swap(Texture2D& other) noexcept {
+    std::swap(_texture_id, other._texture_id);
+    std::swap(_texture, other._texture);
+    std::swap(_has_texture, other._has_texture);
 }
 
 GL_UTIL_END
\ No newline at end of file
@@ -0,0 +1,152 @@
+#include "../include/gl_util/gl_uniform_buffer.h"
+#include "../include/gl_util/gl_shader.h"
+#include "../include/gl_util/gl_state_cache.h"
+#include <cstring>
+
+GL_UTIL_BEGIN
+
+/* ----------------------------------------------------------------------------------- */
+/*                               UniformRingBuffer utility                             */
+/* ----------------------------------------------------------------------------------- */
+
+/**
+ * @brief Round the size up to a multiple of the alignment.
+ */
+static size_t alignUp(size_t size, size_t alignment) {
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+/* ----------------------------------------------------------------------------------- */
+/*                            UniformRingBuffer implementation                         */
+/* ----------------------------------------------------------------------------------- */
+
+UniformRingBuffer::UniformRingBuffer(GLuint binding, size_t element_size,
+                                     size_t capacity, uint8_t frames)
+    : _binding(binding)
+    , _element_size(element_size)
+    , _capacity(capacity > 0 ? capacity : 1)
+    , _buffer(0)
+    , _data(nullptr)
+    , _fences(frames > 0 ? frames : 1, nullptr)
+    , _frame(0)
+    , _count(0)
+    , _last_offset(-1) {
+    checkInitStatus();
+
+    // Each range bound must start at a multiple of the offset alignment.
+    GLint alignment = 256;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    _stride = alignUp(_element_size, alignment > 0 ? alignment : 256);
+
+    GLint max_size = 0;
+    glGetIntegerv(GL_MAX_UNIFORM_BLOCK_SIZE, &max_size);
+    if(_element_size > (size_t)max_size) {
+        GL_UTIL_LOG("WARNING: The uniform block of %zu bytes exceeds the limit %d!\n",
+                    _element_size, max_size);
+    }
+
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT |
+                             GL_MAP_COHERENT_BIT;
+    GLsizeiptr size = _stride * _capacity * _fences.size();
+    glGenBuffers(1, &_buffer);
+    StateCache::current().bindBuffer(GL_UNIFORM_BUFFER, _buffer);
+    glBufferStorage(GL_UNIFORM_BUFFER, size, nullptr, flags);
+    _data = (uint8_t*)glMapBufferRange(GL_UNIFORM_BUFFER, 0, size, flags);
+    if(!_data) {
+        GL_UTIL_LOG("ERROR: Failed to map the uniform buffer!\n");
+    }
+}
+
+UniformRingBuffer::~UniformRingBuffer() {
+    for(GLsync& fence : _fences) {
+        if(fence) {
+            glDeleteSync(fence);
+        }
+    }
+    if(_data) {
+        StateCache::current().bindBuffer(GL_UNIFORM_BUFFER, _buffer);
+        glUnmapBuffer(GL_UNIFORM_BUFFER);
+    }
+    StateCache::current().deleteBuffers(1, &_buffer);
+}
+
+bool UniformRingBuffer::beginFrame() {
+    // Fence the segment written by the previous frame, which is read by its draws.
+    if(_count > 0) {
+        if(_fences[_frame]) {
+            glDeleteSync(_fences[_frame]);
+        }
+        _fences[_frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+    _frame = (_frame + 1) % _fences.size();
+    _count = 0;
+
+    GLsync& fence = _fences[_frame];
+    if(!fence) {
+        return true;
+    }
+    bool is_free = true;
+    GLenum status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    if(status == GL_TIMEOUT_EXPIRED) {
+        // The GPU is more than 'frames' frames behind, wait instead of overwriting.
+        is_free = false;
+        while(status == GL_TIMEOUT_EXPIRED) {
+            status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+        }
+    }
+    glDeleteSync(fence);
+    fence = nullptr;
+    return is_free;
+}
+
+bool UniformRingBuffer::push(const void* data) {
+    if(!_data) return false;
+    if(_count >= _capacity) {
+        GL_UTIL_LOG("ERROR: The uniform buffer is full, %zu elements per frame!\n",
+                    _capacity);
+        return false;
+    }
+    size_t offset = (_frame * _capacity + _count) * _stride;
+    memcpy(_data + offset, data, _element_size);
+    _count++;
+    _last_offset = offset;
+    bind();
+    return true;
+}
+
+void UniformRingBuffer::bind() const {
+    if(_last_offset < 0) return;
+    StateCache::current().bindBufferRange(GL_UNIFORM_BUFFER, _binding, _buffer,
+                                          _last_offset, _element_size);
+}
+
+GLuint UniformRingBuffer::binding() const {
+    return _binding;
+}
+
+size_t UniformRingBuffer::size() const {
+    return _count;
+}
+
+size_t UniformRingBuffer::capacity() const {
+    return _capacity;
+}
+
+bool UniformRingBuffer::attach(Shader& shader, std::string_view block) const {
+    for(const ShaderResource& resource : shader.uniformBlocks()) {
+        if(resource.name != block) continue;
+        // A larger block would read beyond the element.
+        if((size_t)resource.data_size > _element_size) {
+            GL_UTIL_LOG("ERROR: The uniform block '%s' is %d bytes, larger than the "
+                        "%zu bytes of the buffer!\n", resource.name.c_str(),
+                        resource.data_size, _element_size);
+            return false;
+        }
+        return shader.bindUniformBlock(block, _binding);
+    }
+    GL_UTIL_LOG("ERROR: Shader has no active uniform block '%.*s'!\n",
+                (int)block.size(), block.data());
+    return false;
+}
+
+GL_UTIL_END
@@ -0,0 +1,137 @@
+#include "../include/gl_util/gl_uniform_cache.h"
+#include "gl_hash.h"
+#include <cstring>
+
+GL_UTIL_BEGIN
+
+/* ----------------------------------------------------------------------------------- */
+/*                              UniformLocationCache utility                           */
+/* ----------------------------------------------------------------------------------- */
+
+/** The initial number of entries, enough for most of the programs **/
+static const size_t INITIAL_CAPACITY = 32;
+
+/* ----------------------------------------------------------------------------------- */
+/*                           UniformLocationCache implementation                       */
+/* ----------------------------------------------------------------------------------- */
+
+UniformLocationCache::UniformLocationCache()
+    : _entries(INITIAL_CAPACITY)
+    , _count(0) {
+}
+
+GLint UniformLocationCache::location(GLuint program, std::string_view name) {
+    uint64_t hash = hashString(name);
+    size_t mask = _entries.size() - 1;
+    size_t index = hash & mask;
+    while(_entries[index].is_used) {
+        const Entry& entry = _entries[index];
+        if(entry.hash == hash && entry.name == name) {
+            return entry.location;
+        }
+        index = (index + 1) & mask;
+    }
+
+    // Miss, query the driver with a null-terminated copy of the name.
+    Entry& entry = _entries[index];
+    entry.name.assign(name.data(), name.size());
+    entry.hash = hash;
+    entry.location = glGetUniformLocation(program, entry.name.c_str());
+    entry.is_used = true;
+    GLint location = entry.location;
+
+    if(++_count * 2 > _entries.size()) {
+        grow();
+    }
+    return location;
+}
+
+void UniformLocationCache::clear() {
+    for(Entry& entry : _entries) {
+        entry.is_used = false;
+        entry.name.clear();
+    }
+    _count = 0;
+}
+
+size_t UniformLocationCache::size() const {
+    return _count;
+}
+
+// --- PRIVATE ---
+void UniformLocationCache::grow() {
+    std::vector<Entry> entries(_entries.size() * 2);
+    size_t mask = entries.size() - 1;
+    for(Entry& entry : _entries) {
+        if(!entry.is_used) continue;
+        size_t index = entry.hash & mask;
+        while(entries[index].is_used) {
+            index = (index + 1) & mask;
+        }
+        entries[index] = std::move(entry);
+    }
+    _entries.swap(entries);
+}
+
+/* ----------------------------------------------------------------------------------- */
+/*                            UniformValueCache implementation                         */
+/* ----------------------------------------------------------------------------------- */
+
+UniformValueCache::UniformValueCache()
+    : _issued(0)
+    , _skipped(0) {
+}
+
+bool UniformValueCache::update(GLint location, const void* data, GLsizei count,
+                               size_t size) {
+    if(location < 0 || count <= 0) return false;
+    if(_slots.size() < size_t(location) + count) {
+        _slots.resize(size_t(location) + count);
+    }
+
+    bool is_changed = false;
+    const uint8_t* bytes = (const uint8_t*)data;
+    for(GLsizei i = 0; i < count; i++) {
+        Slot& slot = _slots[location + i];
+        const uint8_t* value = bytes + i * size;
+        if(slot.size != size) {
+            // First value of the location, or of another size. The bytes reserved are
+            // reused if large enough, otherwise larger ones are appended.
+            if(slot.capacity < size) {
+                slot.offset = _data.size();
+                slot.capacity = size;
+                _data.resize(_data.size() + size);
+            }
+            slot.size = size;
+            memcpy(_data.data() + slot.offset, value, size);
+            is_changed = true;
+        }
+        else if(memcmp(_data.data() + slot.offset, value, size) != 0) {
+            memcpy(_data.data() + slot.offset, value, size);
+            is_changed = true;
+        }
+    }
+    if(is_changed) _issued++;
+    else _skipped++;
+    return is_changed;
+}
+
+void UniformValueCache::clear() {
+    _slots.clear();
+    _data.clear();
+}
+
+uint64_t UniformValueCache::issuedCount() const {
+    return _issued;
+}
+
+uint64_t UniformValueCache::skippedCount() const {
+    return _skipped;
+}
+
+void UniformValueCache::resetCounters() {
+    _issued = 0;
+    _skipped = 0;
+}
+
+GL_UTIL_END
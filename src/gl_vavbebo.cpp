@@ -1,18 +1,39 @@
 #include "../include/gl_util/gl_vavbebo.h"
+#include "../include/gl_util/gl_state_cache.h"
+#include <utility>
 
 GL_UTIL_BEGIN
 
 VAVBEBO::VAVBEBO() 
-    : _is_bind(false)
+    : _vao(0)
+    , _vbo(0)
+    , _ebo(0)
+    , _is_bind(false)
     , _has_ebo(false) {
     checkInitStatus();
 }
 
+VAVBEBO::VAVBEBO(VAVBEBO&& other) noexcept
+    : VAVBEBO() {
+    swap(other);
+}
+
+VAVBEBO& VAVBEBO::operator=(VAVBEBO&& other) noexcept {
+    // The GL objects of this VAVBEBO are deleted with the temporary.
+    VAVBEBO moved(std::move(other));
+    swap(moved);
+    return *this;
+}
+
 VAVBEBO::~VAVBEBO() { 
     if(_is_bind){
-        glDeleteVertexArrays(1, &_vao);
-        glDeleteBuffers(1, &_vbo);
-        glDeleteBuffers(1, &_ebo);
+        StateCache& cache = StateCache::current();
+        cache.deleteVertexArrays(1, &_vao);
+        cache.deleteBuffers(1, &_vbo);
+        // The EBO is only generated with indices.
+        if(_has_ebo) {
+            cache.deleteBuffers(1, &_ebo);
+        }
         _is_bind = false;
     }
 }
@@ -20,10 +41,11 @@ VAVBEBO::~VAVBEBO() {
 void VAVBEBO::bind(const float* vertices, size_t vertices_size, 
                    const std::vector<uint8_t>& vertex_desc, const unsigned int* indices, 
                    size_t indices_size, size_t gl_draw_mode) {
+    StateCache& cache = StateCache::current();
     if(!_is_bind) {
         glGenVertexArrays(1, &_vao);
     }
-    glBindVertexArray(_vao);
+    cache.bindVertexArray(_vao);
     
     // Generate VBO
     if(!_is_bind) {
@@ -31,15 +53,15 @@ void VAVBEBO::bind(const float* vertices, size_t vertices_size,
     }
     /* Bind the GL_ARRAY_BUFFER to VBO, after which, any calling of the 
        GL_ARRAY_BUFFER will configure current binded VBO. */
-    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+    cache.bindBuffer(GL_ARRAY_BUFFER, _vbo);
     // Copy the input vertices into our GL_ARRAY_BUFFER.
     glBufferData(GL_ARRAY_BUFFER, vertices_size, vertices, gl_draw_mode);
 
     if(indices){
-        if(!_is_bind) {
+        if(!_has_ebo) {
             glGenBuffers(1, &_ebo);
         }
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _ebo);
+        cache.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _ebo);
         glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices_size, indices, GL_STATIC_DRAW);
         _has_ebo= true;
     }
@@ -69,11 +91,21 @@ void VAVBEBO::bindVertexArray() {
         GL_UTIL_LOG("ERROR: No valid vertices are binded to VAVBEBO object!\n");
         return;
     }  
-    glBindVertexArray(_vao);
+    StateCache::current().bindVertexArray(_vao);
 }
 
 void VAVBEBO::unBindVertexArray() {
-    glBindVertexArray(0);
+    StateCache::current().bindVertexArray(0);
+}
+
+// --- PRIVATE ---
+void VAVBEBO::swap(VAVBEBO& other) noexcept {
+    std::swap(_vao, other._vao);
+    std::swap(_vbo, other._vbo);
+    std::swap(_ebo, other._ebo);
+    std::swap(_is_bind, other._is_bind);
+    std::swap(_has_ebo, other._has_ebo);
+    std::swap(_vertex_desc, other._vertex_desc);
 }
 
 GL_UTIL_END
\ No newline at end of file
@@ -1,4 +1,10 @@
 #include "../include/gl_util/gl_window.h"
+#include "../include/gl_util/gl_profiler.h"
+#include "../include/gl_util/gl_render_thread.h"
+#include "../include/gl_util/gl_state_cache.h"
+#include "gl_headless.h"
+#include <cstring>
+#include <thread>
 
 GL_UTIL_BEGIN
 
@@ -11,6 +17,16 @@ GL_UTIL_BEGIN
  */
 static GLFWwindow* shared_window = nullptr;
 
+/**
+ * @brief Whether the shared context has been created.
+ */
+static bool has_init = false;
+
+/**
+ * @brief The backend that created the shared context.
+ */
+static ContextBackend context_backend = BACKEND_GLFW;
+
 /**
  * @brief GLFW error callback.
  * 
@@ -23,9 +39,11 @@ void errorCallback(int error, const char* desc) {
 
 void clear(GLFWwindow* window, float R, float G, float B, float A, 
            bool is_depth_on) {
-    glfwMakeContextCurrent(window);
+    if(glfwGetCurrentContext() != window) {
+        glfwMakeContextCurrent(window);
+    }
     // Clear and reset window color, this step is just a STATUS SETTING
-    glClearColor(R, G, B, A);   
+    StateCache::current().clearColor(R, G, B, A);
     // Clear previous color buffer and validate current color buffer
     glClear(GL_COLOR_BUFFER_BIT); 
 
@@ -40,11 +58,27 @@ void clear(GLFWwindow* window, uint8_t R, uint8_t G, uint8_t B, float A,
     clear(window, 1.f*R/255.f, 1.f*G/255.f, 1.f*B/255.f, 1.f*A/255.f, is_depth_on);
 }
 
-uint8_t init(uint8_t ver_major, uint8_t ver_minor) {
-    if(shared_window) {
+uint8_t init(uint8_t ver_major, uint8_t ver_minor, ContextBackend backend) {
+    if(has_init) {
         return 1;
     }
 
+    if(backend != BACKEND_GLFW) {
+        context_backend = createHeadlessContext(ver_major, ver_minor, backend);
+        if(context_backend == BACKEND_GLFW) {
+            GL_UTIL_ERROR("ERROR: cannot create headless OpenGL %d.%d context, make "
+                          "sure gl_util is built with EGL or OSMesa.\n", 
+                          ver_major, ver_minor);
+            std::exit(-1);
+        }
+        if(!gladLoadGLLoader((GLADloadproc)getHeadlessProcAddress)){
+            GL_UTIL_ERROR("GLAD ERROR: failed to initialize GLAD.\n");
+            std::exit(-1);
+        }
+        has_init = true;
+        return 2;
+    }
+
     // Add error callback before any GLFW operation.
     glfwSetErrorCallback(errorCallback);
     // Initialize GLFW.
@@ -83,16 +117,60 @@ uint8_t init(uint8_t ver_major, uint8_t ver_minor) {
         std::exit(-1);
     }
 
-    glEnable(GL_MULTISAMPLE);
+    StateCache::current().enable(GL_MULTISAMPLE);
+    has_init = true;
     return 2;
 }
 
 void terminate() {
-    glfwTerminate();
+    StateCache::invalidateContext(nullptr);
+    if(context_backend == BACKEND_GLFW) {
+        glfwTerminate();
+        shared_window = nullptr;
+    }
+    else {
+        destroyHeadlessContext();
+        context_backend = BACKEND_GLFW;
+    }
+    has_init = false;
+}
+
+ContextBackend backend() {
+    return context_backend;
+}
+
+bool makeSharedContextCurrent() {
+    if(!has_init) {
+        return false;
+    }
+    if(context_backend == BACKEND_GLFW) {
+        glfwMakeContextCurrent(shared_window);
+        return true;
+    }
+    return makeHeadlessContextCurrent();
+}
+
+void* getProcAddress(const char* name) {
+    if(context_backend == BACKEND_GLFW) {
+        return (void*)glfwGetProcAddress(name);
+    }
+    return getHeadlessProcAddress(name);
+}
+
+bool hasExtension(const char* name) {
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for(GLint i = 0; i < count; i++) {
+        const char* extension = (const char*)glGetStringi(GL_EXTENSIONS, i);
+        if(extension && strcmp(extension, name) == 0) {
+            return true;
+        }
+    }
+    return false;
 }
 
 void checkInitStatus() {
-    if(shared_window) {
+    if(has_init) {
         return;
     }
     GL_UTIL_ERROR("ERROR, the GL context has not been initialized. "
@@ -125,10 +203,20 @@ Window::Window(uint16_t width, uint16_t height, const std::string &name,
     : width(width)
     , height(height)
     , name(name)
-    , _is_depth_test_on(false) {
+    , _is_depth_test_on(false)
+    , _profiler(nullptr)
+    , _present_mode(PRESENT_DEFAULT)
+    , _is_present_mode_dirty(false)
+    , _frame_period(0)
+    , _event_loop(nullptr) {
 
     // Initialize OpenGL context using default version.
     init();
+    if(context_backend != BACKEND_GLFW) {
+        GL_UTIL_ERROR("ERROR: gl_util::Window is not available with a headless "
+                      "context backend.\n");
+        std::exit(EXIT_FAILURE);
+    }
 
     glfwWindowHint(GLFW_DECORATED, !is_transparent);
     glfwWindowHint(GLFW_TRANSPARENT_FRAMEBUFFER, is_transparent);
@@ -142,6 +230,11 @@ Window::Window(uint16_t width, uint16_t height, const std::string &name,
 }
 
 Window::~Window() {
+    stopRenderThread();
+    if(_event_loop) {
+        _event_loop->detach(*this);
+    }
+    StateCache::invalidateContext(_window);
     glfwDestroyWindow(_window);
 }
 
@@ -155,9 +248,10 @@ void Window::activate() {
 }
 
 void Window::deactivate() {
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    StateCache& cache = StateCache::current();
+    cache.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    cache.bindBuffer(GL_ARRAY_BUFFER, 0);
+    cache.bindVertexArray(0);
     glfwMakeContextCurrent(nullptr);
 }
 
@@ -170,8 +264,18 @@ void Window::show() {
 }
 
 void Window::clear() {
+    if(_profiler) {
+        if(glfwGetCurrentContext() != _window) {
+            glfwMakeContextCurrent(_window);
+        }
+        _profiler->beginFrame();
+    }
     gl_util::clear(_window, _color.R, _color.G, _color.B, _color.A, _is_depth_test_on);
     
+    // Keyboard state can only be queried on the main thread.
+    if(_render_thread && _render_thread->isCurrentThread()) {
+        return;
+    }
     // Monitoring kewboard event
     if(_callback_kbe){
         _callback_kbe(this->_window); 
@@ -182,9 +286,23 @@ void Window::clear() {
 }
 
 void Window::refresh() {
+    if(_profiler) {
+        _profiler->endFrame();
+    }
+    if(_is_present_mode_dirty) {
+        applyPresentMode();
+    }
+    if(_frame_period.count() > 0) {
+        waitFrameDeadline();
+    }
     // Swap the double buffer
     glfwSwapBuffers(_window);
 
+    // Events can only be processed on the main thread, and the EventLoop polls
+    // events for all the windows.
+    if(_event_loop || (_render_thread && _render_thread->isCurrentThread())) {
+        return;
+    }
     // Check the keys pressed/released, mouse moved etc. events.
     glfwPollEvents();
 }
@@ -194,13 +312,14 @@ bool Window::shouldClose() {
 }
 
 void Window::enableDepthTest(size_t depth_cmp) {
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(depth_cmp);
+    StateCache& cache = StateCache::current();
+    cache.enable(GL_DEPTH_TEST);
+    cache.depthFunc(depth_cmp);
     _is_depth_test_on = true;
 }
 
 void Window::disableDepthTest() {
-    glDisable(GL_DEPTH_TEST);
+    StateCache::current().disable(GL_DEPTH_TEST);
     _is_depth_test_on = false;
 }
 
@@ -256,7 +375,144 @@ void Window::processKeyboardEvent() {
     }
 }
 
+void Window::applyPresentMode() {
+    // The swap interval is a state of current context, which is restored after.
+    GLFWwindow* context = glfwGetCurrentContext();
+    if(context != _window) {
+        glfwMakeContextCurrent(_window);
+    }
+    if(_present_mode == PRESENT_ADAPTIVE) {
+        if(glfwExtensionSupported("GLX_EXT_swap_control_tear") ||
+           glfwExtensionSupported("WGL_EXT_swap_control_tear")) {
+            glfwSwapInterval(-1);
+        }
+        else {
+            GL_UTIL_LOG("WARNING: EXT_swap_control_tear is not supported, "
+                        "PRESENT_VSYNC is used instead.\n");
+            _present_mode = PRESENT_VSYNC;
+        }
+    }
+    if(_present_mode == PRESENT_VSYNC) {
+        glfwSwapInterval(1);
+    }
+    else if(_present_mode == PRESENT_UNCAPPED) {
+        glfwSwapInterval(0);
+    }
+    _is_present_mode_dirty = false;
+    if(context != _window) {
+        glfwMakeContextCurrent(context);
+    }
+}
+
+/**
+ * @brief The time before the frame deadline to stop sleeping and start spinning, 
+ * which covers the wake-up latency of the OS scheduler.
+ */
+static const std::chrono::microseconds FRAME_SPIN_MARGIN(1500);
+
+void Window::waitFrameDeadline() {
+    using Clock = std::chrono::steady_clock;
+    _frame_deadline += _frame_period;
+    Clock::time_point now = Clock::now();
+    // Restart from now if the frame is too late, rather than rushing several frames.
+    if(now > _frame_deadline + _frame_period) {
+        _frame_deadline = now;
+        return;
+    }
+    if(_frame_deadline - now > FRAME_SPIN_MARGIN) {
+        std::this_thread::sleep_until(_frame_deadline - FRAME_SPIN_MARGIN);
+    }
+    while(Clock::now() < _frame_deadline) {
+        std::this_thread::yield();
+    }
+}
+
 void Window::setKeyboardEventCallBack(CallbackKeyboardEvent callbackfunc) {
     _callback_kbe = callbackfunc;
 }
+
+void Window::setPresentMode(PresentMode mode) {
+    _present_mode = mode;
+    _is_present_mode_dirty = true;
+}
+
+PresentMode Window::presentMode() const {
+    return _present_mode;
+}
+
+void Window::setFrameLimit(float fps) {
+    if(fps <= 0) {
+        _frame_period = std::chrono::steady_clock::duration::zero();
+        return;
+    }
+    _frame_period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(1.0 / fps));
+    _frame_deadline = std::chrono::steady_clock::now();
+}
+
+void Window::setProfiler(Profiler* profiler) {
+    _profiler = profiler;
+}
+
+bool Window::startRenderThread() {
+    if(_render_thread) {
+        return true;
+    }
+    // A context can only be current on one thread.
+    if(glfwGetCurrentContext() == _window) {
+        glFlush();
+        glfwMakeContextCurrent(nullptr);
+    }
+    _render_thread.reset(new RenderThread(_window));
+    return true;
+}
+
+void Window::stopRenderThread() {
+    _render_thread.reset();
+}
+
+bool Window::hasRenderThread() const {
+    return _render_thread != nullptr;
+}
+
+std::future<void> Window::submit(std::function<void()> task) {
+    if(_render_thread) {
+        return _render_thread->submit(std::move(task));
+    }
+    std::packaged_task<void()> packaged(std::move(task));
+    std::future<void> future = packaged.get_future();
+    activate();
+    packaged();
+    return future;
+}
+
+void Window::wait() {
+    if(_render_thread) {
+        _render_thread->wait();
+    }
+}
+
+bool Window::popEvent(Event& event) {
+    std::lock_guard<std::mutex> lock(_event_mutex);
+    if(_events.empty()) {
+        return false;
+    }
+    event = _events.front();
+    _events.pop_front();
+    return true;
+}
+
+/**
+ * @brief The maximum number of events in the queue of a window, the oldest events are
+ * dropped if the queue is not consumed.
+ */
+static const size_t MAX_QUEUED_EVENTS = 1024;
+
+void Window::pushEvent(const Event& event) {
+    std::lock_guard<std::mutex> lock(_event_mutex);
+    if(_events.size() >= MAX_QUEUED_EVENTS) {
+        _events.pop_front();
+    }
+    _events.push_back(event);
+}
 GL_UTIL_END